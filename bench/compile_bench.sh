@@ -0,0 +1,110 @@
+#!/bin/sh
+#
+# Times the preprocessing and compilation of M_DECLARE_MOCK and M_IMPLEMENT_MOCK
+# (Linux).
+#
+# A translation unit of N mocks of M parameters each is generated for every N
+# and M, and is timed under every compiler, printing CSV rows of
+# `compiler,stage,mocks,params,seconds` where stage is one of:
+#     preprocess    $CC -E
+#     syntax        $CC -fsyntax-only
+#     compile       $CC -c $CFLAGS
+#
+# Usage:
+#     CPPUTEST_HOME=/path/to/cpputest bench/compile_bench.sh > compile.csv
+#
+# Environment:
+#     CPPUTEST_HOME    the CppUTest installation prefix (required)
+#     COMPILERS        the C compilers (default: the available of gcc and clang)
+#     CFLAGS           the C compiler flags of the compile stage (default: -O2)
+#     MOCKS            the numbers of mocks (default: 10 100 500)
+#     PARAMS           the numbers of parameters (default: 0 1 4 16 31)
+#     REPEAT           the runs averaged per row (default: 3)
+
+set -e
+
+BENCH_DIR=$(cd "$(dirname "$0")" && pwd)
+: "${CPPUTEST_HOME:?CPPUTEST_HOME must be set}"
+if [ -z "${COMPILERS+x}" ]; then
+    COMPILERS=
+    for compiler in gcc clang; do
+        if command -v "$compiler" > /dev/null 2>&1; then
+            COMPILERS="$COMPILERS $compiler"
+        fi
+    done
+fi
+CFLAGS=${CFLAGS:--O2}
+MOCKS=${MOCKS:-"10 100 500"}
+PARAMS=${PARAMS:-"0 1 4 16 31"}
+REPEAT=${REPEAT:-3}
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+# Writes a translation unit of $1 mocks of $2 parameters each to stdout; the
+# parameters cycle through the scalar M_PARAM_* types.
+generate() {
+    awk -v mocks="$1" -v params="$2" 'BEGIN {
+        split("int|unsigned int|long|unsigned long|double|const char *|void *", ctype, "|");
+        split("INT|UINT|LONG|ULONG|DOUBLE|CHAR_PTR|IN_PTR", mtype, "|");
+        print "#include \"moxie.h\"";
+        for (i = 0; i < mocks; ++i) {
+            proto = "";
+            list = "";
+            for (j = 0; j < params; ++j) {
+                k = (j % 7) + 1;
+                proto = proto (j ? ", " : "") ctype[k] " p" j;
+                list = list ",\n    M_PARAM_" mtype[k] "(" ctype[k] ",p" j ")";
+            }
+            if (params == 0) {
+                proto = "void";
+                list = ",\n    M_PARAM_VOID";
+            }
+            printf "\nM_EXPORT_MOCK\nextern int compile_bench_%d(%s);\n", i, proto;
+            for (s = 0; s < 2; ++s) {
+                printf "\n%s(\n    M_RETURN_INT(int),\n    compile_bench_%d%s\n);\n", (s ? "M_IMPLEMENT_MOCK" : "M_DECLARE_MOCK"), i, list;
+            }
+        }
+    }'
+}
+
+# Prints the average seconds of $REPEAT runs of the command, or fails once a
+# run fails.
+measure() {
+    start=$(date +%s.%N)
+    run=0
+    while [ "$run" -lt "$REPEAT" ]; do
+        "$@" > /dev/null || return 1
+        run=$((run + 1))
+    done
+    end=$(date +%s.%N)
+    awk -v start="$start" -v end="$end" -v repeat="$REPEAT" 'BEGIN { printf "%.4f\n", (end - start) / repeat }'
+}
+
+# Prints the CSV row of the stage $1 of $mocks and $params, as measured by the
+# command; exits upon a failed command, as `set -e` does not apply to the
+# command substitution.
+row() {
+    stage=$1
+    shift
+    seconds=$(measure "$@") || {
+        echo "compile_bench.sh: $stage of $mocks mocks of $params params failed" >&2
+        exit 1
+    }
+    echo "$compiler,$stage,$mocks,$params,$seconds"
+}
+
+echo "compiler,stage,mocks,params,seconds"
+for mocks in $MOCKS; do
+    for params in $PARAMS; do
+        source="$WORK_DIR/compile_bench_${mocks}_${params}.c"
+        generate "$mocks" "$params" > "$source"
+        for compiler in $COMPILERS; do
+            set -- -std=c99 -I"$BENCH_DIR/../include" -I"$CPPUTEST_HOME/include"
+            row preprocess "$compiler" "$@" -E "$source"
+            row syntax "$compiler" "$@" -fsyntax-only "$source"
+            # shellcheck disable=SC2086
+            row compile "$compiler" "$@" $CFLAGS -c -o "$WORK_DIR/compile_bench.o" "$source"
+        done
+    done
+done
@@ -0,0 +1,763 @@
+/*
+ * Moxie Runtime Benchmark:
+ * Measures the ns/call of the mocked functions of moxie_bench.h in every mode
+ * of the generated __wrap_ function, and prints one CSV row per measurement:
+ *
+ *     mode,function,threads,iterations,ns_per_call
+ *
+ * Modes:
+ * - direct: calls the realFunc through M_REAL_FUNC.
+ * - wrap_disabled: calls the Fast Path of the __wrap_ function.
+ * - wrap_spy: calls the Slow Path with Moxie_spy(FUNC).
+ * - wrap_spy_sampled: calls the Fast Path with Moxie_spy(FUNC) and
+ *   Moxie_setSampling(FUNC), such that only 1 in BENCH_SAMPLE_PERIOD calls
+ *   reaches the Slow Path and is counted.
+ * - wrap_return_sequence: calls the Slow Path with
+ *   Moxie_setReturnSequence(FUNC).
+ * - wrap_mock_default: calls the Slow Path with Moxie_enable(FUNC) and the
+ *   default __mCallFunc_ and __mStubFunc_.
+ * - wrap_mock_stub: calls the Slow Path with Moxie_enable(FUNC), the default
+ *   __mCallFunc_, and a user stubFunc.
+ *
+ * The direct, wrap_disabled, wrap_spy, wrap_spy_sampled, and
+ * wrap_return_sequence modes are also
+ * measured with every thread calling the same function concurrently, as the
+ * CppUMock integration is not thread-safe.
+ *
+ * @see run_bench.sh
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "moxie_bench.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Types:
+ */
+
+/**
+ * @brief A BenchFunction describes the callbacks that benchmark a mocked
+ * function in every mode.
+ */
+typedef struct BenchFunction
+{
+    const char *name;
+    void (*callWrap)(unsigned long);
+    void (*callReal)(unsigned long);
+    void (*spy)(void);
+    void (*setSampling)(void);
+    void (*setStub)(void);
+    void (*setSequence)(void);
+} BenchFunction;
+
+/**
+ * @brief A BenchThread describes a thread of a contended measurement.
+ */
+typedef struct BenchThread
+{
+    pthread_t thread;
+    void (*call)(unsigned long);
+    unsigned long iterations;
+} BenchThread;
+
+/*
+ * Bench Macros:
+ */
+
+/**
+ * @brief The number of calls per batch of CppUMock expectations, such that the
+ * expectations of a batch remain cache resident.
+ */
+#define BENCH_BATCH 1000
+
+/**
+ * @brief The period of the wrap_spy_sampled mode.
+ */
+#define BENCH_SAMPLE_PERIOD 100
+
+#define BENCH_ARGS_4(x) x, x, x, x
+#define BENCH_ARGS_16(x) BENCH_ARGS_4(x), BENCH_ARGS_4(x), BENCH_ARGS_4(x), BENCH_ARGS_4(x)
+#define BENCH_ARGS_31(x) BENCH_ARGS_16(x), BENCH_ARGS_4(x), BENCH_ARGS_4(x), BENCH_ARGS_4(x), x, x, x
+
+#define BENCH_SINK benchSink += (unsigned long)
+#define BENCH_VOID (void)
+
+// Defines the loops that call FUNC through the __wrap_ function and through
+// M_REAL_FUNC. With `-Wl,--wrap=FUNC`, the call to FUNC from this translation
+// unit is resolved to __wrap_FUNC by the linker.
+#define BENCH_CALLS(FUNC,SINK,...) \
+static void \
+FUNC##_callWrap(unsigned long iterations) \
+{ \
+    unsigned long benchSink = 0; \
+    unsigned long i; \
+    for (i = 0; i < iterations; ++i) \
+    { \
+        SINK FUNC(__VA_ARGS__); \
+    } \
+    benchResult = benchSink; \
+} \
+static void \
+FUNC##_callReal(unsigned long iterations) \
+{ \
+    unsigned long benchSink = 0; \
+    unsigned long i; \
+    for (i = 0; i < iterations; ++i) \
+    { \
+        SINK M_REAL_FUNC(FUNC)(__VA_ARGS__); \
+    } \
+    benchResult = benchSink; \
+}
+
+// Defines the callbacks that configure a mode of FUNC.
+#define BENCH_CONFIGS(FUNC,SEQUENCE) \
+static void \
+FUNC##_spy(void) \
+{ \
+    Moxie_spy(FUNC)(); \
+} \
+static void \
+FUNC##_setSampling(void) \
+{ \
+    Moxie_setSampling(FUNC)(BENCH_SAMPLE_PERIOD, MOXIE_SAMPLE_PERIODIC); \
+} \
+static void \
+FUNC##_setStub(void) \
+{ \
+    Moxie_setStubFunc(FUNC)(&FUNC##_stubFunc); \
+} \
+static void \
+FUNC##_setSequence(void) \
+{ \
+    Moxie_setReturnSequence(FUNC)(SEQUENCE, 1, MOXIE_REPEAT_LAST); \
+}
+
+#define BENCH_FUNCTION(FUNC) \
+{ \
+    .name = #FUNC, \
+    .callWrap = &FUNC##_callWrap, \
+    .callReal = &FUNC##_callReal, \
+    .spy = &FUNC##_spy, \
+    .setSampling = &FUNC##_setSampling, \
+    .setStub = &FUNC##_setStub, \
+    .setSequence = &FUNC##_setSequence, \
+}
+
+/*
+ * Bench Functions:
+ */
+
+static __thread volatile unsigned long benchResult;
+
+static volatile int benchReady;
+static volatile int benchStart;
+
+static const int benchSequence_bool[1] = { 1 };
+static const int benchSequence_int[1] = { 1 };
+static const unsigned int benchSequence_uint[1] = { 1u };
+static const long benchSequence_long[1] = { 1l };
+static const unsigned long benchSequence_ulong[1] = { 1ul };
+static const double benchSequence_double[1] = { 1.0 };
+static const char *const benchSequence_char_ptr[1] = { "1" };
+static void *const benchSequence_ptr[1] = { &benchObject };
+static const unsigned char benchBuffer[4096];
+
+static void
+bench_ret_void_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, int x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+}
+
+BENCH_CALLS(bench_ret_void, BENCH_VOID, (int)i)
+BENCH_CONFIGS(bench_ret_void, NULL)
+
+static int
+bench_ret_bool_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, int x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+    return 1;
+}
+
+BENCH_CALLS(bench_ret_bool, BENCH_SINK, (int)i)
+BENCH_CONFIGS(bench_ret_bool, benchSequence_bool)
+
+static int
+bench_ret_int_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, int x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+    return 1;
+}
+
+BENCH_CALLS(bench_ret_int, BENCH_SINK, (int)i)
+BENCH_CONFIGS(bench_ret_int, benchSequence_int)
+
+static unsigned int
+bench_ret_uint_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, int x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+    return 1u;
+}
+
+BENCH_CALLS(bench_ret_uint, BENCH_SINK, (int)i)
+BENCH_CONFIGS(bench_ret_uint, benchSequence_uint)
+
+static long
+bench_ret_long_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, int x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+    return 1l;
+}
+
+BENCH_CALLS(bench_ret_long, BENCH_SINK, (int)i)
+BENCH_CONFIGS(bench_ret_long, benchSequence_long)
+
+static unsigned long
+bench_ret_ulong_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, int x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+    return 1ul;
+}
+
+BENCH_CALLS(bench_ret_ulong, BENCH_SINK, (int)i)
+BENCH_CONFIGS(bench_ret_ulong, benchSequence_ulong)
+
+static double
+bench_ret_double_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, int x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+    return 1.0;
+}
+
+BENCH_CALLS(bench_ret_double, BENCH_SINK, (int)i)
+BENCH_CONFIGS(bench_ret_double, benchSequence_double)
+
+static const char *
+bench_ret_char_ptr_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, int x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+    return "1";
+}
+
+BENCH_CALLS(bench_ret_char_ptr, BENCH_SINK, (int)i)
+BENCH_CONFIGS(bench_ret_char_ptr, benchSequence_char_ptr)
+
+static void *
+bench_ret_ptr_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, int x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+    return &benchObject;
+}
+
+BENCH_CALLS(bench_ret_ptr, BENCH_SINK, (int)i)
+BENCH_CONFIGS(bench_ret_ptr, benchSequence_ptr)
+
+static void
+bench_param_bool_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, int x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+}
+
+BENCH_CALLS(bench_param_bool, BENCH_VOID, (int)(i & 1))
+BENCH_CONFIGS(bench_param_bool, NULL)
+
+static void
+bench_param_int_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, int x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+}
+
+BENCH_CALLS(bench_param_int, BENCH_VOID, (int)i)
+BENCH_CONFIGS(bench_param_int, NULL)
+
+static void
+bench_param_uint_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, unsigned int x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+}
+
+BENCH_CALLS(bench_param_uint, BENCH_VOID, (unsigned int)i)
+BENCH_CONFIGS(bench_param_uint, NULL)
+
+static void
+bench_param_long_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, long x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+}
+
+BENCH_CALLS(bench_param_long, BENCH_VOID, (long)i)
+BENCH_CONFIGS(bench_param_long, NULL)
+
+static void
+bench_param_ulong_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, unsigned long x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+}
+
+BENCH_CALLS(bench_param_ulong, BENCH_VOID, i)
+BENCH_CONFIGS(bench_param_ulong, NULL)
+
+static void
+bench_param_double_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, double x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+}
+
+BENCH_CALLS(bench_param_double, BENCH_VOID, (double)i)
+BENCH_CONFIGS(bench_param_double, NULL)
+
+static void
+bench_param_char_ptr_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, const char *x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+}
+
+BENCH_CALLS(bench_param_char_ptr, BENCH_VOID, "1")
+BENCH_CONFIGS(bench_param_char_ptr, NULL)
+
+static void
+bench_param_in_ptr_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, void *x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+}
+
+BENCH_CALLS(bench_param_in_ptr, BENCH_VOID, &benchObject)
+BENCH_CONFIGS(bench_param_in_ptr, NULL)
+
+static void
+bench_param_out_ptr_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, void *x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+}
+
+BENCH_CALLS(bench_param_out_ptr, BENCH_VOID, &benchObject)
+BENCH_CONFIGS(bench_param_out_ptr, NULL)
+
+static void
+bench_param_in_type_ptr_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, BenchType *x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+}
+
+BENCH_CALLS(bench_param_in_type_ptr, BENCH_VOID, &benchObject)
+BENCH_CONFIGS(bench_param_in_type_ptr, NULL)
+
+static void
+bench_param_out_type_ptr_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, BenchType *x)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+}
+
+BENCH_CALLS(bench_param_out_type_ptr, BENCH_VOID, &benchObject)
+BENCH_CONFIGS(bench_param_out_type_ptr, NULL)
+
+static void
+bench_param_buffer_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, const void *x, unsigned long len)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)x;
+    (void)len;
+}
+
+BENCH_CALLS(bench_param_buffer, BENCH_VOID, benchBuffer, sizeof(benchBuffer))
+BENCH_CONFIGS(bench_param_buffer, NULL)
+
+static int
+bench_arity_0_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    return 1;
+}
+
+BENCH_CALLS(bench_arity_0, BENCH_SINK)
+BENCH_CONFIGS(bench_arity_0, benchSequence_int)
+
+static int
+bench_arity_1_stubFunc(MockSupport_c *mockSupport, MockActualCall_c *actualCall, int a0)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)a0;
+    return 1;
+}
+
+BENCH_CALLS(bench_arity_1, BENCH_SINK, (int)i)
+BENCH_CONFIGS(bench_arity_1, benchSequence_int)
+
+static int
+bench_arity_4_stubFunc(MockSupport_c *mockSupport,
+    MockActualCall_c *actualCall,
+    int a0,
+    int a1,
+    int a2,
+    int a3)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)a0;
+    (void)a1;
+    (void)a2;
+    (void)a3;
+    return 1;
+}
+
+BENCH_CALLS(bench_arity_4, BENCH_SINK, BENCH_ARGS_4((int)i))
+BENCH_CONFIGS(bench_arity_4, benchSequence_int)
+
+static int
+bench_arity_16_stubFunc(MockSupport_c *mockSupport,
+    MockActualCall_c *actualCall,
+    int a0,
+    int a1,
+    int a2,
+    int a3,
+    int a4,
+    int a5,
+    int a6,
+    int a7,
+    int a8,
+    int a9,
+    int a10,
+    int a11,
+    int a12,
+    int a13,
+    int a14,
+    int a15)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)a0;
+    (void)a1;
+    (void)a2;
+    (void)a3;
+    (void)a4;
+    (void)a5;
+    (void)a6;
+    (void)a7;
+    (void)a8;
+    (void)a9;
+    (void)a10;
+    (void)a11;
+    (void)a12;
+    (void)a13;
+    (void)a14;
+    (void)a15;
+    return 1;
+}
+
+BENCH_CALLS(bench_arity_16, BENCH_SINK, BENCH_ARGS_16((int)i))
+BENCH_CONFIGS(bench_arity_16, benchSequence_int)
+
+static int
+bench_arity_31_stubFunc(MockSupport_c *mockSupport,
+    MockActualCall_c *actualCall,
+    int a0,
+    int a1,
+    int a2,
+    int a3,
+    int a4,
+    int a5,
+    int a6,
+    int a7,
+    int a8,
+    int a9,
+    int a10,
+    int a11,
+    int a12,
+    int a13,
+    int a14,
+    int a15,
+    int a16,
+    int a17,
+    int a18,
+    int a19,
+    int a20,
+    int a21,
+    int a22,
+    int a23,
+    int a24,
+    int a25,
+    int a26,
+    int a27,
+    int a28,
+    int a29,
+    int a30)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    (void)a0;
+    (void)a1;
+    (void)a2;
+    (void)a3;
+    (void)a4;
+    (void)a5;
+    (void)a6;
+    (void)a7;
+    (void)a8;
+    (void)a9;
+    (void)a10;
+    (void)a11;
+    (void)a12;
+    (void)a13;
+    (void)a14;
+    (void)a15;
+    (void)a16;
+    (void)a17;
+    (void)a18;
+    (void)a19;
+    (void)a20;
+    (void)a21;
+    (void)a22;
+    (void)a23;
+    (void)a24;
+    (void)a25;
+    (void)a26;
+    (void)a27;
+    (void)a28;
+    (void)a29;
+    (void)a30;
+    return 1;
+}
+
+BENCH_CALLS(bench_arity_31, BENCH_SINK, BENCH_ARGS_31((int)i))
+BENCH_CONFIGS(bench_arity_31, benchSequence_int)
+
+static const BenchFunction benchFunctions[] = {
+    BENCH_FUNCTION(bench_ret_void),
+    BENCH_FUNCTION(bench_ret_bool),
+    BENCH_FUNCTION(bench_ret_int),
+    BENCH_FUNCTION(bench_ret_uint),
+    BENCH_FUNCTION(bench_ret_long),
+    BENCH_FUNCTION(bench_ret_ulong),
+    BENCH_FUNCTION(bench_ret_double),
+    BENCH_FUNCTION(bench_ret_char_ptr),
+    BENCH_FUNCTION(bench_ret_ptr),
+    BENCH_FUNCTION(bench_param_bool),
+    BENCH_FUNCTION(bench_param_int),
+    BENCH_FUNCTION(bench_param_uint),
+    BENCH_FUNCTION(bench_param_long),
+    BENCH_FUNCTION(bench_param_ulong),
+    BENCH_FUNCTION(bench_param_double),
+    BENCH_FUNCTION(bench_param_char_ptr),
+    BENCH_FUNCTION(bench_param_in_ptr),
+    BENCH_FUNCTION(bench_param_out_ptr),
+    BENCH_FUNCTION(bench_param_in_type_ptr),
+    BENCH_FUNCTION(bench_param_out_type_ptr),
+    BENCH_FUNCTION(bench_param_buffer),
+    BENCH_FUNCTION(bench_arity_0),
+    BENCH_FUNCTION(bench_arity_1),
+    BENCH_FUNCTION(bench_arity_4),
+    BENCH_FUNCTION(bench_arity_16),
+    BENCH_FUNCTION(bench_arity_31),
+};
+
+static double
+bench_now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+}
+
+static void
+bench_print(const char *mode, const BenchFunction *function, unsigned long threads, unsigned long iterations, double elapsed)
+{
+    printf("%s,%s,%lu,%lu,%.3f\n", mode, function->name, threads, iterations, elapsed / (double)iterations);
+    fflush(stdout);
+}
+
+static void
+bench_single(const char *mode, const BenchFunction *function, void (*call)(unsigned long), unsigned long iterations)
+{
+    double start;
+    (*call)(iterations / 10 + 1);
+    start = bench_now();
+    (*call)(iterations);
+    bench_print(mode, function, 1, iterations, bench_now() - start);
+}
+
+static void *
+bench_worker(void *arg)
+{
+    BenchThread *thread = (BenchThread *)arg;
+    (*thread->call)(thread->iterations / 10 + 1);
+    __atomic_add_fetch(&benchReady, 1, __ATOMIC_ACQ_REL);
+    while (!__atomic_load_n(&benchStart, __ATOMIC_ACQUIRE))
+    {
+    }
+    (*thread->call)(thread->iterations);
+    return NULL;
+}
+
+static void
+bench_contended(const char *mode, const BenchFunction *function, void (*call)(unsigned long), unsigned long iterations, unsigned long threads)
+{
+    BenchThread *workers = (BenchThread *)calloc(threads, sizeof(BenchThread));
+    unsigned long i;
+    double start;
+    __atomic_store_n(&benchReady, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&benchStart, 0, __ATOMIC_RELEASE);
+    for (i = 0; i < threads; ++i)
+    {
+        workers[i].call = call;
+        workers[i].iterations = iterations;
+        pthread_create(&workers[i].thread, NULL, &bench_worker, &workers[i]);
+    }
+    while (__atomic_load_n(&benchReady, __ATOMIC_ACQUIRE) != (int)threads)
+    {
+    }
+    start = bench_now();
+    __atomic_store_n(&benchStart, 1, __ATOMIC_RELEASE);
+    for (i = 0; i < threads; ++i)
+    {
+        pthread_join(workers[i].thread, NULL);
+    }
+    bench_print(mode, function, threads, iterations, bench_now() - start);
+    free(workers);
+}
+
+static void
+bench_mock(const char *mode, const BenchFunction *function, unsigned long iterations)
+{
+    unsigned long batches = iterations / BENCH_BATCH + 1;
+    unsigned long batch;
+    double elapsed = 0.0;
+    for (batch = 0; batch < batches; ++batch)
+    {
+        double start;
+        mock_c()->expectNCalls(BENCH_BATCH, function->name)->ignoreOtherParameters();
+        start = bench_now();
+        (*function->callWrap)(BENCH_BATCH);
+        elapsed += bench_now() - start;
+        mock_c()->checkExpectations();
+        mock_c()->clear();
+    }
+    bench_print(mode, function, 1, batches * BENCH_BATCH, elapsed);
+}
+
+static int
+bench_isEqual(const void *object1, const void *object2)
+{
+    return ((const BenchType *)object1)->value == ((const BenchType *)object2)->value;
+}
+
+static const char *
+bench_valueToString(const void *object)
+{
+    (void)object;
+    return "BenchType";
+}
+
+static void
+bench_copy(void *dst, const void *src)
+{
+    *(BenchType *)dst = *(const BenchType *)src;
+}
+
+int
+main(int argc, char **argv)
+{
+    unsigned long iterations = (argc > 1) ? strtoul(argv[1], NULL, 10) : 10000000UL;
+    unsigned long threads = (argc > 2) ? strtoul(argv[2], NULL, 10) : 4UL;
+    unsigned long mockIterations = iterations / 100 + 1;
+    size_t i;
+
+    mock_c()->installComparator("BenchType *", &bench_isEqual, &bench_valueToString);
+    mock_c()->installCopier("BenchType *", &bench_copy);
+
+    printf("mode,function,threads,iterations,ns_per_call\n");
+    for (i = 0; i < sizeof(benchFunctions) / sizeof(benchFunctions[0]); ++i)
+    {
+        const BenchFunction *function = &benchFunctions[i];
+
+        Moxie_resetAll();
+        bench_single("direct", function, function->callReal, iterations);
+        bench_single("wrap_disabled", function, function->callWrap, iterations);
+        if (threads > 1)
+        {
+            bench_contended("direct", function, function->callReal, iterations, threads);
+            bench_contended("wrap_disabled", function, function->callWrap, iterations, threads);
+        }
+
+        Moxie_resetAll();
+        (*function->spy)();
+        bench_single("wrap_spy", function, function->callWrap, iterations);
+        if (threads > 1)
+        {
+            bench_contended("wrap_spy", function, function->callWrap, iterations, threads);
+        }
+
+        Moxie_resetAll();
+        (*function->spy)();
+        (*function->setSampling)();
+        bench_single("wrap_spy_sampled", function, function->callWrap, iterations);
+        if (threads > 1)
+        {
+            bench_contended("wrap_spy_sampled", function, function->callWrap, iterations, threads);
+        }
+
+        Moxie_resetAll();
+        (*function->setSequence)();
+        bench_single("wrap_return_sequence", function, function->callWrap, iterations);
+        if (threads > 1)
+        {
+            bench_contended("wrap_return_sequence", function, function->callWrap, iterations, threads);
+        }
+
+        Moxie_resetAll();
+        Moxie_findByName(function->name)->enable();
+        bench_mock("wrap_mock_default", function, mockIterations);
+        (*function->setStub)();
+        bench_mock("wrap_mock_stub", function, mockIterations);
+    }
+    Moxie_resetAll();
+    mock_c()->removeAllComparatorsAndCopiers();
+    return 0;
+}
@@ -0,0 +1,315 @@
+#ifndef BENCH_MOXIE_BENCH_H_
+#define BENCH_MOXIE_BENCH_H_
+
+#include "moxie.h"
+
+/*
+ * Types:
+ */
+
+/**
+ * @brief A BenchType is the custom type of the M_PARAM_IN_TYPE_PTR and
+ * M_PARAM_OUT_TYPE_PTR benchmarks.
+ */
+typedef struct BenchType
+{
+    int value;
+} BenchType;
+
+extern BenchType benchObject;
+
+/*
+ * Benchmarked Functions:
+ * Each M_RETURN_* type is benchmarked with a single M_PARAM_INT, each M_PARAM_*
+ * type is benchmarked with M_RETURN_VOID, and each arity is benchmarked with
+ * M_RETURN_INT and M_PARAM_INTs.
+ */
+
+M_EXPORT_MOCK
+extern void bench_ret_void(int x);
+
+M_EXPORT_MOCK
+extern int bench_ret_bool(int x);
+
+M_EXPORT_MOCK
+extern int bench_ret_int(int x);
+
+M_EXPORT_MOCK
+extern unsigned int bench_ret_uint(int x);
+
+M_EXPORT_MOCK
+extern long bench_ret_long(int x);
+
+M_EXPORT_MOCK
+extern unsigned long bench_ret_ulong(int x);
+
+M_EXPORT_MOCK
+extern double bench_ret_double(int x);
+
+M_EXPORT_MOCK
+extern const char *bench_ret_char_ptr(int x);
+
+M_EXPORT_MOCK
+extern void *bench_ret_ptr(int x);
+
+M_EXPORT_MOCK
+extern void bench_param_bool(int x);
+
+M_EXPORT_MOCK
+extern void bench_param_int(int x);
+
+M_EXPORT_MOCK
+extern void bench_param_uint(unsigned int x);
+
+M_EXPORT_MOCK
+extern void bench_param_long(long x);
+
+M_EXPORT_MOCK
+extern void bench_param_ulong(unsigned long x);
+
+M_EXPORT_MOCK
+extern void bench_param_double(double x);
+
+M_EXPORT_MOCK
+extern void bench_param_char_ptr(const char * x);
+
+M_EXPORT_MOCK
+extern void bench_param_in_ptr(void * x);
+
+M_EXPORT_MOCK
+extern void bench_param_out_ptr(void * x);
+
+M_EXPORT_MOCK
+extern void bench_param_in_type_ptr(BenchType * x);
+
+M_EXPORT_MOCK
+extern void bench_param_out_type_ptr(BenchType * x);
+
+M_EXPORT_MOCK
+extern void bench_param_buffer(const void * x, unsigned long len);
+
+M_EXPORT_MOCK
+extern int bench_arity_0(void);
+
+M_EXPORT_MOCK
+extern int bench_arity_1(int a0);
+
+M_EXPORT_MOCK
+extern int bench_arity_4(int a0, int a1, int a2, int a3);
+
+M_EXPORT_MOCK
+extern int bench_arity_16(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7, int a8, int a9, int a10, int a11, int a12, int a13, int a14, int a15);
+
+M_EXPORT_MOCK
+extern int bench_arity_31(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7, int a8, int a9, int a10, int a11, int a12, int a13, int a14, int a15, int a16, int a17, int a18, int a19, int a20, int a21, int a22, int a23, int a24, int a25, int a26, int a27, int a28, int a29, int a30);
+
+/*
+ * Mocks:
+ */
+
+M_DECLARE_MOCK(
+    M_RETURN_VOID,
+    bench_ret_void,
+    M_PARAM_INT(int,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_BOOL(int),
+    bench_ret_bool,
+    M_PARAM_INT(int,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    bench_ret_int,
+    M_PARAM_INT(int,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_UINT(unsigned int),
+    bench_ret_uint,
+    M_PARAM_INT(int,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_LONG(long),
+    bench_ret_long,
+    M_PARAM_INT(int,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_ULONG(unsigned long),
+    bench_ret_ulong,
+    M_PARAM_INT(int,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_DOUBLE(double),
+    bench_ret_double,
+    M_PARAM_INT(int,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_CHAR_PTR(const char *),
+    bench_ret_char_ptr,
+    M_PARAM_INT(int,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_PTR(void *),
+    bench_ret_ptr,
+    M_PARAM_INT(int,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_VOID,
+    bench_param_bool,
+    M_PARAM_BOOL(int,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_VOID,
+    bench_param_int,
+    M_PARAM_INT(int,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_VOID,
+    bench_param_uint,
+    M_PARAM_UINT(unsigned int,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_VOID,
+    bench_param_long,
+    M_PARAM_LONG(long,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_VOID,
+    bench_param_ulong,
+    M_PARAM_ULONG(unsigned long,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_VOID,
+    bench_param_double,
+    M_PARAM_DOUBLE(double,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_VOID,
+    bench_param_char_ptr,
+    M_PARAM_CHAR_PTR(const char *,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_VOID,
+    bench_param_in_ptr,
+    M_PARAM_IN_PTR(void *,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_VOID,
+    bench_param_out_ptr,
+    M_PARAM_OUT_PTR(void *,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_VOID,
+    bench_param_in_type_ptr,
+    M_PARAM_IN_TYPE_PTR(BenchType *,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_VOID,
+    bench_param_out_type_ptr,
+    M_PARAM_OUT_TYPE_PTR(BenchType *,x)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_VOID,
+    bench_param_buffer,
+    M_PARAM_BUFFER(const void *,x,len),
+    M_PARAM_ULONG(unsigned long,len)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    bench_arity_0,
+    M_PARAM_VOID
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    bench_arity_1,
+    M_PARAM_INT(int,a0)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    bench_arity_4,
+    M_PARAM_INT(int,a0),
+    M_PARAM_INT(int,a1),
+    M_PARAM_INT(int,a2),
+    M_PARAM_INT(int,a3)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    bench_arity_16,
+    M_PARAM_INT(int,a0),
+    M_PARAM_INT(int,a1),
+    M_PARAM_INT(int,a2),
+    M_PARAM_INT(int,a3),
+    M_PARAM_INT(int,a4),
+    M_PARAM_INT(int,a5),
+    M_PARAM_INT(int,a6),
+    M_PARAM_INT(int,a7),
+    M_PARAM_INT(int,a8),
+    M_PARAM_INT(int,a9),
+    M_PARAM_INT(int,a10),
+    M_PARAM_INT(int,a11),
+    M_PARAM_INT(int,a12),
+    M_PARAM_INT(int,a13),
+    M_PARAM_INT(int,a14),
+    M_PARAM_INT(int,a15)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    bench_arity_31,
+    M_PARAM_INT(int,a0),
+    M_PARAM_INT(int,a1),
+    M_PARAM_INT(int,a2),
+    M_PARAM_INT(int,a3),
+    M_PARAM_INT(int,a4),
+    M_PARAM_INT(int,a5),
+    M_PARAM_INT(int,a6),
+    M_PARAM_INT(int,a7),
+    M_PARAM_INT(int,a8),
+    M_PARAM_INT(int,a9),
+    M_PARAM_INT(int,a10),
+    M_PARAM_INT(int,a11),
+    M_PARAM_INT(int,a12),
+    M_PARAM_INT(int,a13),
+    M_PARAM_INT(int,a14),
+    M_PARAM_INT(int,a15),
+    M_PARAM_INT(int,a16),
+    M_PARAM_INT(int,a17),
+    M_PARAM_INT(int,a18),
+    M_PARAM_INT(int,a19),
+    M_PARAM_INT(int,a20),
+    M_PARAM_INT(int,a21),
+    M_PARAM_INT(int,a22),
+    M_PARAM_INT(int,a23),
+    M_PARAM_INT(int,a24),
+    M_PARAM_INT(int,a25),
+    M_PARAM_INT(int,a26),
+    M_PARAM_INT(int,a27),
+    M_PARAM_INT(int,a28),
+    M_PARAM_INT(int,a29),
+    M_PARAM_INT(int,a30)
+);
+
+#endif // BENCH_MOXIE_BENCH_H_
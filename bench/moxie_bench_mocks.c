@@ -0,0 +1,206 @@
+#include "moxie_bench.h"
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_VOID,
+    bench_ret_void,
+    M_PARAM_INT(int,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_BOOL(int),
+    bench_ret_bool,
+    M_PARAM_INT(int,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    bench_ret_int,
+    M_PARAM_INT(int,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_UINT(unsigned int),
+    bench_ret_uint,
+    M_PARAM_INT(int,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_LONG(long),
+    bench_ret_long,
+    M_PARAM_INT(int,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_ULONG(unsigned long),
+    bench_ret_ulong,
+    M_PARAM_INT(int,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_DOUBLE(double),
+    bench_ret_double,
+    M_PARAM_INT(int,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_CHAR_PTR(const char *),
+    bench_ret_char_ptr,
+    M_PARAM_INT(int,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_PTR(void *),
+    bench_ret_ptr,
+    M_PARAM_INT(int,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_VOID,
+    bench_param_bool,
+    M_PARAM_BOOL(int,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_VOID,
+    bench_param_int,
+    M_PARAM_INT(int,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_VOID,
+    bench_param_uint,
+    M_PARAM_UINT(unsigned int,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_VOID,
+    bench_param_long,
+    M_PARAM_LONG(long,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_VOID,
+    bench_param_ulong,
+    M_PARAM_ULONG(unsigned long,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_VOID,
+    bench_param_double,
+    M_PARAM_DOUBLE(double,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_VOID,
+    bench_param_char_ptr,
+    M_PARAM_CHAR_PTR(const char *,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_VOID,
+    bench_param_in_ptr,
+    M_PARAM_IN_PTR(void *,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_VOID,
+    bench_param_out_ptr,
+    M_PARAM_OUT_PTR(void *,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_VOID,
+    bench_param_in_type_ptr,
+    M_PARAM_IN_TYPE_PTR(BenchType *,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_VOID,
+    bench_param_out_type_ptr,
+    M_PARAM_OUT_TYPE_PTR(BenchType *,x)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_VOID,
+    bench_param_buffer,
+    M_PARAM_BUFFER(const void *,x,len),
+    M_PARAM_ULONG(unsigned long,len)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    bench_arity_0,
+    M_PARAM_VOID
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    bench_arity_1,
+    M_PARAM_INT(int,a0)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    bench_arity_4,
+    M_PARAM_INT(int,a0),
+    M_PARAM_INT(int,a1),
+    M_PARAM_INT(int,a2),
+    M_PARAM_INT(int,a3)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    bench_arity_16,
+    M_PARAM_INT(int,a0),
+    M_PARAM_INT(int,a1),
+    M_PARAM_INT(int,a2),
+    M_PARAM_INT(int,a3),
+    M_PARAM_INT(int,a4),
+    M_PARAM_INT(int,a5),
+    M_PARAM_INT(int,a6),
+    M_PARAM_INT(int,a7),
+    M_PARAM_INT(int,a8),
+    M_PARAM_INT(int,a9),
+    M_PARAM_INT(int,a10),
+    M_PARAM_INT(int,a11),
+    M_PARAM_INT(int,a12),
+    M_PARAM_INT(int,a13),
+    M_PARAM_INT(int,a14),
+    M_PARAM_INT(int,a15)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    bench_arity_31,
+    M_PARAM_INT(int,a0),
+    M_PARAM_INT(int,a1),
+    M_PARAM_INT(int,a2),
+    M_PARAM_INT(int,a3),
+    M_PARAM_INT(int,a4),
+    M_PARAM_INT(int,a5),
+    M_PARAM_INT(int,a6),
+    M_PARAM_INT(int,a7),
+    M_PARAM_INT(int,a8),
+    M_PARAM_INT(int,a9),
+    M_PARAM_INT(int,a10),
+    M_PARAM_INT(int,a11),
+    M_PARAM_INT(int,a12),
+    M_PARAM_INT(int,a13),
+    M_PARAM_INT(int,a14),
+    M_PARAM_INT(int,a15),
+    M_PARAM_INT(int,a16),
+    M_PARAM_INT(int,a17),
+    M_PARAM_INT(int,a18),
+    M_PARAM_INT(int,a19),
+    M_PARAM_INT(int,a20),
+    M_PARAM_INT(int,a21),
+    M_PARAM_INT(int,a22),
+    M_PARAM_INT(int,a23),
+    M_PARAM_INT(int,a24),
+    M_PARAM_INT(int,a25),
+    M_PARAM_INT(int,a26),
+    M_PARAM_INT(int,a27),
+    M_PARAM_INT(int,a28),
+    M_PARAM_INT(int,a29),
+    M_PARAM_INT(int,a30)
+);
@@ -0,0 +1,226 @@
+#include "moxie_bench.h"
+
+/*
+ * Real Functions:
+ * The real functions are defined in their own translation unit such that the
+ * compiler cannot inline them into the benchmark loops.
+ */
+
+BenchType benchObject = { .value = 1 };
+
+void
+bench_ret_void(int x)
+{
+    (void)x;
+}
+
+int
+bench_ret_bool(int x)
+{
+    (void)x;
+    return 1;
+}
+
+int
+bench_ret_int(int x)
+{
+    (void)x;
+    return 1;
+}
+
+unsigned int
+bench_ret_uint(int x)
+{
+    (void)x;
+    return 1u;
+}
+
+long
+bench_ret_long(int x)
+{
+    (void)x;
+    return 1l;
+}
+
+unsigned long
+bench_ret_ulong(int x)
+{
+    (void)x;
+    return 1ul;
+}
+
+double
+bench_ret_double(int x)
+{
+    (void)x;
+    return 1.0;
+}
+
+const char *
+bench_ret_char_ptr(int x)
+{
+    (void)x;
+    return "1";
+}
+
+void *
+bench_ret_ptr(int x)
+{
+    (void)x;
+    return &benchObject;
+}
+
+void
+bench_param_bool(int x)
+{
+    (void)x;
+}
+
+void
+bench_param_int(int x)
+{
+    (void)x;
+}
+
+void
+bench_param_uint(unsigned int x)
+{
+    (void)x;
+}
+
+void
+bench_param_long(long x)
+{
+    (void)x;
+}
+
+void
+bench_param_ulong(unsigned long x)
+{
+    (void)x;
+}
+
+void
+bench_param_double(double x)
+{
+    (void)x;
+}
+
+void
+bench_param_char_ptr(const char * x)
+{
+    (void)x;
+}
+
+void
+bench_param_in_ptr(void * x)
+{
+    (void)x;
+}
+
+void
+bench_param_out_ptr(void * x)
+{
+    (void)x;
+}
+
+void
+bench_param_in_type_ptr(BenchType * x)
+{
+    (void)x;
+}
+
+void
+bench_param_out_type_ptr(BenchType * x)
+{
+    (void)x;
+}
+
+void
+bench_param_buffer(const void * x, unsigned long len)
+{
+    (void)x;
+    (void)len;
+}
+
+int
+bench_arity_0(void)
+{
+    return 1;
+}
+
+int
+bench_arity_1(int a0)
+{
+    (void)a0;
+    return 1;
+}
+
+int
+bench_arity_4(int a0, int a1, int a2, int a3)
+{
+    (void)a0;
+    (void)a1;
+    (void)a2;
+    (void)a3;
+    return 1;
+}
+
+int
+bench_arity_16(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7, int a8, int a9, int a10, int a11, int a12, int a13, int a14, int a15)
+{
+    (void)a0;
+    (void)a1;
+    (void)a2;
+    (void)a3;
+    (void)a4;
+    (void)a5;
+    (void)a6;
+    (void)a7;
+    (void)a8;
+    (void)a9;
+    (void)a10;
+    (void)a11;
+    (void)a12;
+    (void)a13;
+    (void)a14;
+    (void)a15;
+    return 1;
+}
+
+int
+bench_arity_31(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7, int a8, int a9, int a10, int a11, int a12, int a13, int a14, int a15, int a16, int a17, int a18, int a19, int a20, int a21, int a22, int a23, int a24, int a25, int a26, int a27, int a28, int a29, int a30)
+{
+    (void)a0;
+    (void)a1;
+    (void)a2;
+    (void)a3;
+    (void)a4;
+    (void)a5;
+    (void)a6;
+    (void)a7;
+    (void)a8;
+    (void)a9;
+    (void)a10;
+    (void)a11;
+    (void)a12;
+    (void)a13;
+    (void)a14;
+    (void)a15;
+    (void)a16;
+    (void)a17;
+    (void)a18;
+    (void)a19;
+    (void)a20;
+    (void)a21;
+    (void)a22;
+    (void)a23;
+    (void)a24;
+    (void)a25;
+    (void)a26;
+    (void)a27;
+    (void)a28;
+    (void)a29;
+    (void)a30;
+    return 1;
+}
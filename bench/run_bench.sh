@@ -0,0 +1,40 @@
+#!/bin/sh
+#
+# Builds and runs the Moxie runtime benchmark (Linux).
+#
+# Usage:
+#     CPPUTEST_HOME=/path/to/cpputest bench/run_bench.sh [iterations] [threads] > bench.csv
+#
+# Environment:
+#     CPPUTEST_HOME    the CppUTest installation prefix (required)
+#     CPPUTEST_LIBDIR  the directory of libCppUTest.a and libCppUTestExt.a
+#                      (default: $CPPUTEST_HOME/lib)
+#     CC               the C compiler (default: cc)
+#     CFLAGS           the C compiler flags (default: -O2)
+#     BENCH_OUT        the benchmark executable (default: bench/moxie_bench)
+
+set -e
+
+BENCH_DIR=$(cd "$(dirname "$0")" && pwd)
+: "${CPPUTEST_HOME:?CPPUTEST_HOME must be set}"
+CPPUTEST_LIBDIR=${CPPUTEST_LIBDIR:-"$CPPUTEST_HOME/lib"}
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:--O2}
+BENCH_OUT=${BENCH_OUT:-"$BENCH_DIR/moxie_bench"}
+
+# Every M_IMPLEMENT_MOCK of moxie_bench_mocks.c names its function on its own
+# line, from which the `ld --wrap`s are derived.
+WRAPS=$(sed -n 's/^    \(bench_[a-z0-9_]*\),$/-Wl,--wrap=\1/p' "$BENCH_DIR/moxie_bench_mocks.c")
+
+# shellcheck disable=SC2086
+$CC -std=c99 $CFLAGS \
+    -I"$BENCH_DIR/../include" \
+    -I"$CPPUTEST_HOME/include" \
+    -o "$BENCH_OUT" \
+    "$BENCH_DIR/moxie_bench.c" \
+    "$BENCH_DIR/moxie_bench_mocks.c" \
+    "$BENCH_DIR/moxie_bench_real.c" \
+    $WRAPS \
+    -L"$CPPUTEST_LIBDIR" -lCppUTestExt -lCppUTest -lstdc++ -lm -lpthread
+
+"$BENCH_OUT" "$@"
@@ -3,12 +3,579 @@
 
 #include "CppUTestExt/MockSupport_c.h"
 
+#include <string.h>
+#include <time.h>
+
+#if defined(MOXIE_NATIVE_BACKEND) && !defined(MOXIE_NATIVE_CAPACITY)
+#define MOXIE_NATIVE_CAPACITY 64
+#endif
+
+#if defined(MOXIE_RTLD_NEXT) && !defined(__darwin__)
+#define _M_RTLD_NEXT
+#include <dlfcn.h>
+#endif
+
+#if defined(MOXIE_IFUNC_DISPATCH) && !defined(_M_RTLD_NEXT) && !defined(__darwin__)
+#define _M_IFUNC_DISPATCH
+#include <fcntl.h>
+#include <sys/syscall.h>
+#endif
+
+#ifdef MOXIE_ENV_ENABLE
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+#if defined(MOXIE_TRACE_CAPACITY) && !defined(MOXIE_TRACE_SHARDS)
+#define MOXIE_TRACE_SHARDS 64
+#endif
+
+#ifdef MOXIE_TRACE_CAPACITY
+#include <stdio.h>
+#include <unistd.h>
+#endif
+
+#if defined(MOXIE_SHARED_SLOW_PATH) && !defined(MOXIE_NATIVE_BACKEND)
+#define _M_SHARED_SLOW_PATH
+#endif
+
+#ifdef MOXIE_STATS_EXPORT
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef MOXIE_MEMOIZE_CAPACITY
+#include <stddef.h>
+#endif
+
+#if defined(MOXIE_CALLER_FILTER) && !defined(MOXIE_CALLER_RANGES)
+#define MOXIE_CALLER_RANGES 64
+#endif
+
+#ifdef MOXIE_CALLER_FILTER
+#include <link.h>
+#include <stdint.h>
+#endif
+
+#if defined(MOXIE_FORK_SHARDING) || defined(MOXIE_THREAD_LOCAL_STATE)
+#include <pthread.h>
+#endif
+
+#if defined(MOXIE_DEFER_CAPACITY) && !defined(MOXIE_NATIVE_BACKEND)
+#define _M_DEFERRED
+#endif
+
+#ifdef MOXIE_RECORD_REPLAY
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Configuration Macros:
+ * These macros are optional and must be defined before including moxie.h.
+ */
+
+/**
+ * @def MOXIE_ATOMIC_STATE
+ * @brief Accesses every MoxieState through atomic loads and stores such that
+ * mocked functions can be called from multiple threads while their mocks are
+ * toggled.
+ *
+ * The Fast Path performs a relaxed load of the mockFlag, which compiles to the
+ * same plain load as a non-atomic build on mainstream targets. The Slow Path
+ * performs acquire loads and the API Functions perform release stores.
+ *
+ * @code
+ * #define MOXIE_ATOMIC_STATE
+ * #include "moxie.h"
+ * @endcode
+ */
+
+/**
+ * @def MOXIE_THREAD_LOCAL_STATE
+ * @brief Scopes the API Functions to the calling thread such that independent
+ * tests can be executed on multiple threads of a single process.
+ *
+ * A thread that has not configured the specified function falls back to the
+ * global configuration, which is set by Moxie_publish(FUNC)(). The Fast Path
+ * remains a single load of a per-function counter of enabled configurations.
+ *
+ * @note The configuration of a thread is reset once it exits, through a
+ * pthread key destructor, such that the other threads of the process return
+ * to the Fast Path; the executable must link `-pthread` on glibc versions
+ * prior to 2.34.
+ * @note The counters (e.g. Moxie_callCount(FUNC)) and the cursors of the
+ * injections, record and replay, and Moxie_expect(FUNC) are shared by every
+ * thread, such that Moxie_reset(FUNC)() only resets
+ * Moxie_threadCallCount(FUNC) of the calling thread, and Moxie_resetAll()
+ * resets the shared ones.
+ */
+
+/**
+ * @def MOXIE_CAPTURE_CAPACITY
+ * @brief Generates a statically allocated ring buffer of the specified number
+ * of MoxieArgs_##FUNC for every M_IMPLEMENT_MOCK such that the arguments of
+ * the most recent calls can be inspected through Moxie_captured(FUNC).
+ *
+ * @note A power of two is recommended, as the ring buffer is indexed modulo
+ * the capacity on every captured call.
+ *
+ * @code
+ * #define MOXIE_CAPTURE_CAPACITY 1024
+ * #include "moxie.h"
+ * @endcode
+ */
+
+/**
+ * @def MOXIE_PROFILE_SHARDS
+ * @brief Generates the specified number of statically allocated latency
+ * histograms for every M_IMPLEMENT_MOCK such that Moxie_profile(FUNC) can
+ * record the latencies of the realFunc.
+ *
+ * Every thread records into one of the histograms, which are assigned round
+ * robin, such that the threads only share a histogram once there are more
+ * threads than histograms.
+ *
+ * @code
+ * #define MOXIE_PROFILE_SHARDS 8
+ * #include "moxie.h"
+ * @endcode
+ */
+
+/**
+ * @def MOXIE_TRACE_CAPACITY
+ * @brief Generates MOXIE_TRACE_SHARDS (default: 64) statically allocated ring
+ * buffers of the specified number of MoxieTraceEvents, which are shared by
+ * every mocked function, such that Moxie_trace(FUNC) can record a timeline of
+ * the calls for Moxie_dumpTrace().
+ *
+ * Every thread appends to one of the ring buffers, which are assigned round
+ * robin, such that the threads only share a ring buffer once there are more
+ * threads than ring buffers; an event is appended without any allocation or
+ * lock.
+ *
+ * @note Every translation unit of an executable must define the same
+ * MOXIE_TRACE_CAPACITY and MOXIE_TRACE_SHARDS, as the ring buffers are shared.
+ *
+ * @code
+ * #define MOXIE_TRACE_CAPACITY 4096
+ * #include "moxie.h"
+ * @endcode
+ */
+
+/**
+ * @def MOXIE_RTLD_NEXT
+ * @brief Interposes every mocked function at runtime (Linux) rather than
+ * through `-Wl,--wrap=...` LDFLAGS.
+ *
+ * M_IMPLEMENT_MOCK defines FUNC itself as an alias of __wrap_##FUNC, and
+ * __real_##FUNC resolves the next definition of FUNC through
+ * dlsym(RTLD_NEXT, ...) upon its first call, which is then cached in the
+ * MoxieState. Hence, the executable is linked without any `ld --wrap`s, and
+ * the calls made from within shared objects are mocked as well.
+ *
+ * @note The realFunc must be defined in a shared object (e.g. libc) rather
+ * than in the executable itself.
+ * @note The executable must export the mocked functions to the shared objects,
+ * e.g. with `-rdynamic`, and link `-ldl` on glibc versions prior to 2.34.
+ *
+ * @code
+ * #define MOXIE_RTLD_NEXT
+ * #include "moxie.h"
+ * @endcode
+ */
+
+/**
+ * @def MOXIE_IFUNC_DISPATCH
+ * @brief Resolves every __wrap_##FUNC once at load time through a GNU ifunc
+ * (Linux), such that a process that is not armed calls the realFunc without
+ * the Fast Path load and branch.
+ *
+ * A process is armed when the MOXIE_ARMED environment variable is set to a
+ * value other than "0", or the MOXIE_ENABLE environment variable is set to a
+ * non-empty value (see MOXIE_ENV_ENABLE), upon startup; otherwise, __wrap_##FUNC is bound
+ * directly to __real_##FUNC and the API Functions have no effect on its calls.
+ *
+ * @note The environment is read from /proc/self/environ, as the resolvers are
+ * called by the dynamic linker before the C library is initialized.
+ * @note The environment is read through raw system calls, such that static
+ * executables (`-static` and `-static-pie`) are supported on x86-64 and
+ * AArch64, which are the only architectures supported.
+ *
+ * @code
+ * #define MOXIE_IFUNC_DISPATCH
+ * #include "moxie.h"
+ * @endcode
+ */
+
+/**
+ * @def MOXIE_NATIVE_BACKEND
+ * @brief Replaces the CppUMock integration with an allocation-free expectation
+ * engine, such that enabled mocks neither allocate nor compare any strings.
+ *
+ * The expectations of every function are claimed from a statically allocated
+ * arena of MOXIE_NATIVE_CAPACITY MoxieExpectation_##FUNC through
+ * Moxie_expect(FUNC) and are matched strictly in order; the parameters are
+ * compared by position rather than by name, and the mismatched calls are
+ * reported by Moxie_verify(FUNC).
+ *
+ * @note The stubFunc and callFunc of a mock are invoked with NULL
+ * MockSupport_c and MockActualCall_c.
+ * @note M_PARAM_IN_TYPE_PTR compares pointers; M_PARAM_OUT_PTR,
+ * M_PARAM_OUT_TYPE_PTR, M_PARAM_OUT_BUFFER, M_PARAM_IGNORE, and M_PARAM_CUSTOM
+ * always match; and the LEN_PARAM of M_PARAM_BUFFER must name a sibling
+ * parameter.
+ *
+ * @code
+ * #define MOXIE_NATIVE_BACKEND
+ * #define MOXIE_NATIVE_CAPACITY 256
+ * #include "moxie.h"
+ * @endcode
+ */
+
+/**
+ * @def MOXIE_ENV_ENABLE
+ * @brief Arms the mocked functions named by the MOXIE_ENABLE environment
+ * variable upon startup, such that an existing executable can be investigated
+ * without any test code.
+ *
+ * MOXIE_ENABLE is a comma-separated list of `FUNC[:SCOPE][/MODE]...` entries,
+ * where FUNC is the name of a mocked function or `*` for every mocked
+ * function, and MODE is one of `mock`, `spy`, `profile`, `trace` (if
+ * MOXIE_TRACE_CAPACITY is defined), or `sample=N`. An entry without `mock`,
+ * `spy`, `profile`, or `trace` enables the CppUMock integration:
+ *
+ *     MOXIE_ENABLE=read,write:IO,malloc/spy/sample=1000 ./executable
+ *
+ * An entry with an unknown or unsupported MODE, or a `sample=` that is not a
+ * number, is reported to stderr and skipped as a whole.
+ *
+ * @note MOXIE_ENABLE is parsed once per executable or shared object by a
+ * constructor, which applies it in a single pass over the registry. A
+ * MOXIE_ENABLE longer than 4095 characters is reported to stderr and ignored.
+ *
+ * @code
+ * #define MOXIE_ENV_ENABLE
+ * #include "moxie.h"
+ * @endcode
+ */
+
+/**
+ * @def MOXIE_STATS_EXPORT
+ * @brief Defines Moxie_exportStats() and Moxie_updateStats(), which publish
+ * the statistics of every mocked function of the registry into a named POSIX
+ * shared memory segment, such that an external tool can poll a running
+ * process without any syscalls in the process.
+ *
+ * @note The translation units of Moxie_exportStats() must enable POSIX (e.g.
+ * `_POSIX_C_SOURCE 200809L`), and must link `-lrt` on glibc versions prior to
+ * 2.17.
+ *
+ * @code
+ * #define MOXIE_STATS_EXPORT
+ * #include "moxie.h"
+ * @endcode
+ */
+
+/**
+ * @def MOXIE_SHARED_SLOW_PATH
+ * @brief Implements the Slow Path of every mocked function with one shared
+ * routine, which is driven by a constant descriptor of the parameters and
+ * return of the function, rather than with a full copy per mocked function.
+ *
+ * Each mocked function only packs its arguments into an array on its stack and
+ * calls the shared routine, such that hundreds of mocks compile faster into
+ * far less code. The shared routine is emitted as a weak symbol, such that a
+ * single copy remains in the executable or shared object.
+ *
+ * @note The parameters of M_PARAM_CUSTOM and the return of M_RETURN_CUSTOM, as
+ * well as any callFunc or stubFunc set by Moxie_setCallFunc(FUNC) or
+ * Moxie_setStubFunc(FUNC), are still invoked by the mocked function itself.
+ * @note MOXIE_SHARED_SLOW_PATH is ignored by MOXIE_NATIVE_BACKEND.
+ *
+ * @code
+ * #define MOXIE_SHARED_SLOW_PATH
+ * #include "moxie.h"
+ * @endcode
+ */
+
+/**
+ * @def MOXIE_RECORD_REPLAY
+ * @brief Generates the record and replay of every M_IMPLEMENT_MOCK such that
+ * Moxie_record(FUNC) appends the results of the realFunc to the file of
+ * Moxie_startRecording(), from which Moxie_replay(FUNC) serves them back
+ * through the memory mapping of Moxie_startReplay() without calling the
+ * realFunc.
+ *
+ * A MoxieRecord holds the return value and the pointees of the output
+ * parameters of a call, which are matched upon replay by the order of the
+ * calls of the function or by an FNV-1a hash of its arguments. The hash
+ * covers the values of the scalar parameters, the strings of
+ * M_PARAM_CHAR_PTR, and the buffers of M_PARAM_BUFFER, but not the other
+ * pointers, whose addresses differ between runs.
+ *
+ * @note The pointee of an M_PARAM_OUT_PTR or M_PARAM_OUT_TYPE_PTR is recorded
+ * by the size of its type, such that a `void *` output parameter is not
+ * recorded unless it is described by M_PARAM_OUT_BUFFER.
+ * @note The values are copied bytewise, such that the returned pointers and
+ * the pointers within the output parameters are not meaningful upon replay.
+ *
+ * @code
+ * #define MOXIE_RECORD_REPLAY
+ * #include "moxie.h"
+ * @endcode
+ */
+
+/**
+ * @def MOXIE_MEMOIZE_CAPACITY
+ * @brief Generates a statically allocated open-addressing cache of the
+ * specified number of return values for every M_IMPLEMENT_MOCK such that
+ * Moxie_memoize(FUNC) can return the cached results of a pure realFunc.
+ *
+ * The cache is keyed by the FNV-1a hash of the arguments of the call, which
+ * covers the values of the scalar parameters, the strings of
+ * M_PARAM_CHAR_PTR, and the buffers of M_PARAM_BUFFER; Moxie_memoize(FUNC)
+ * refuses the functions with any other pointer parameter. An entry is probed
+ * at most 4 slots from its home slot, which it overwrites once those slots are
+ * taken, such that every lookup is bounded.
+ *
+ * @note A power of two is recommended, as the cache is indexed modulo the
+ * capacity on every memoized call.
+ *
+ * @code
+ * #define MOXIE_MEMOIZE_CAPACITY 256
+ * #include "moxie.h"
+ * @endcode
+ */
+
+/**
+ * @def MOXIE_CALLER_FILTER
+ * @brief Limits the armed mocks to the calls made from the modules named by
+ * Moxie_setCallerModules() (Linux), such that the calls made by CppUTest, the
+ * C++ runtime, and the other shared objects reach the realFunc directly.
+ *
+ * An armed __wrap_##FUNC looks up its return address in the sorted address
+ * ranges of the executable segments of the named modules, which are collected
+ * once through dl_iterate_phdr(). The lookup is a binary search of at most
+ * MOXIE_CALLER_RANGES (default: 64) ranges, whose result is cached by every
+ * thread for the range or gap that contains the address, such that the
+ * repeated calls from the same code skip the search.
+ *
+ * @note The Fast Path of the mocks that are not armed is unchanged.
+ * @note The translation units of Moxie_setCallerModules() must enable GNU
+ * extensions (e.g. `_GNU_SOURCE`) for the declarations of <link.h>.
+ * @note Every translation unit of an executable must define the same
+ * MOXIE_CALLER_RANGES, as the ranges are shared.
+ *
+ * @code
+ * #define MOXIE_CALLER_FILTER
+ * #include "moxie.h"
+ * @endcode
+ */
+
+/**
+ * @def MOXIE_FORK_SHARDING
+ * @brief Registers pthread_atfork() handlers upon startup which give every
+ * forked worker a statistics and file namespace of its own, such that the
+ * mock-heavy tests can be sharded across forked processes.
+ *
+ * A forked child resets the counters of every mocked function of the
+ * registry (but not their configuration), discards the MoxieTraceEvents of
+ * its parent, and reopens the recording of Moxie_startRecording() under its
+ * own path. A worker is identified by Moxie_shardSuffix(), e.g. ".3" for the
+ * third child of the process, which suffixes every path and segment name that
+ * the worker passes to Moxie_dumpTrace(), Moxie_startRecording(),
+ * Moxie_startReplay(), Moxie_exportStats(), and Moxie_unexportStats().
+ *
+ * @note The mappings of Moxie_startReplay() and Moxie_exportStats() are
+ * inherited as they are; a worker should export a stats segment of its own
+ * rather than update the segment of its parent.
+ * @note The executable must link `-pthread` on glibc versions prior to 2.34.
+ *
+ * @code
+ * #define MOXIE_FORK_SHARDING
+ * #include "moxie.h"
+ * @endcode
+ */
+
+/**
+ * @def MOXIE_DEFER_CAPACITY
+ * @brief Generates a statically allocated log of the specified number of
+ * 8-byte slots, which is shared by every mocked function, such that the calls
+ * of Moxie_defer(FUNC) only append their packed arguments to the log, which
+ * is replayed into the actualCall() of CppUMock in call order before the
+ * expectations are checked.
+ *
+ * A deferred call takes 4 slots, plus a slot per parameter, plus the slots of
+ * the copied strings of M_PARAM_CHAR_PTR and buffers of M_PARAM_BUFFER; the
+ * log is flushed into CppUMock once it is full.
+ *
+ * @note The calls with a custom callFunc, an M_PARAM_OUT_PTR,
+ * M_PARAM_OUT_TYPE_PTR, M_PARAM_OUT_BUFFER, M_PARAM_IN_TYPE_PTR, or an
+ * M_PARAM_CUSTOM are processed at once, as their arguments must be seen by
+ * CppUMock during the call.
+ * @note Every call that is processed by CppUMock at once, including the calls
+ * of the mocked functions that are not deferred, flushes the log first, such
+ * that CppUMock sees every call in call order.
+ * @note The deferred functions should be called from a single thread at a
+ * time, like CppUMock itself, and Moxie_resetAll() discards the log.
+ * @note MOXIE_DEFER_CAPACITY is ignored by MOXIE_NATIVE_BACKEND.
+ *
+ * @code
+ * #define MOXIE_DEFER_CAPACITY 65536
+ * #include "moxie.h"
+ * @endcode
+ */
+
 /*
  * Types:
  */
 
+/**
+ * @brief A MoxieCounter counts the calls of a mocked function on a single
+ * thread.
+ *
+ * The count is only valid while its epoch matches the callEpoch of the
+ * MoxieState, such that a reset does not need to visit every thread.
+ */
+typedef struct MoxieCounter
+{
+    unsigned long epoch;
+    unsigned long count;
+} MoxieCounter;
+
+/**
+ * @brief A MoxieSampler counts down the unsampled calls of a mocked function
+ * on a single thread.
+ *
+ * The countdown is only valid while its state and epoch match the MoxieState
+ * that sampled the last call and its sampleEpoch, such that a reconfiguration
+ * does not need to visit every thread. The skips of the countdown (drawn less
+ * countdown) are published upon the next sampled call of the thread.
+ */
+typedef struct MoxieSampler
+{
+    const struct MoxieState *state;
+    unsigned long epoch;
+    unsigned long countdown;
+    unsigned long drawn;
+} MoxieSampler;
+
+/**
+ * @brief A MoxieRepeat describes how a return sequence proceeds once every
+ * value of the sequence has been returned.
+ */
+typedef enum MoxieRepeat
+{
+    /** Defers to the CppUMock integration or the realFunc. */
+    MOXIE_REPEAT_NONE = 0,
+    /** Repeats the last value of the sequence. */
+    MOXIE_REPEAT_LAST = 1,
+    /** Repeats the sequence from its first value. */
+    MOXIE_REPEAT_CYCLE = 2,
+} MoxieRepeat;
+
+/**
+ * @brief A MoxieSampling describes how the sampled calls of a mocked function
+ * are selected.
+ */
+typedef enum MoxieSampling
+{
+    /** Samples every N-th call of each thread, starting with its first. */
+    MOXIE_SAMPLE_PERIODIC = 0,
+    /** Samples each call with a probability of 1/N. */
+    MOXIE_SAMPLE_RANDOM = 1,
+} MoxieSampling;
+
+/**
+ * @brief A MoxieReplay describes how the calls of a mocked function are
+ * matched to the MoxieRecords of a replay.
+ */
+typedef enum MoxieReplay
+{
+    /** Replays the next MoxieRecord of the function, in recording order. */
+    MOXIE_REPLAY_ORDER = 0,
+    /** Replays the first MoxieRecord of the function with equal arguments. */
+    MOXIE_REPLAY_ARGUMENTS = 1,
+} MoxieReplay;
+
+/**
+ * @brief A MoxieWait describes how the latency of a MoxieInjection is added.
+ */
+typedef enum MoxieWait
+{
+    /** Busy-waits on the monotonic clock. */
+    MOXIE_WAIT_SPIN = 0,
+    /** Sleeps with nanosleep(). */
+    MOXIE_WAIT_SLEEP = 1,
+} MoxieWait;
+
+/**
+ * @brief A MoxieInjection describes the latency and the faults injected in
+ * front of the realFunc of a mocked function.
+ *
+ * A zero-initialized MoxieInjection injects nothing. Every call draws from a
+ * generator of the seed and the sequence number of the call, such that a
+ * single-threaded run injects the same latencies and faults upon every run.
+ */
+typedef struct MoxieInjection
+{
+    /** The MoxieWait of the latency. */
+    MoxieWait wait;
+    /** The probability in [0, 1] that a call is delayed. */
+    double latencyProbability;
+    /** The fixed latency of a delayed call in nanoseconds. */
+    unsigned long latencyNs;
+    /** The bound of the uniformly distributed latency added to latencyNs. */
+    unsigned long jitterNs;
+    /** The probability in [0, 1] that a call returns the faultValue. */
+    double faultProbability;
+    /** The seed of the generator. */
+    unsigned long seed;
+} MoxieInjection;
+
+/**
+ * @brief The assumed size of a cache line, which separates the fields that
+ * are written upon every call from the fields that are only read.
+ */
+#define _M_CACHE_LINE 64
+#define _M_CACHE_ALIGNED __attribute__((aligned(_M_CACHE_LINE)))
+
+/**
+ * @brief The number of linear sub-buckets of every power of two of a
+ * MoxieHistogram, as a power of two.
+ */
+#define _M_HISTOGRAM_SUB_BITS 3
+#define _M_HISTOGRAM_BUCKETS ((64 - _M_HISTOGRAM_SUB_BITS + 1) << _M_HISTOGRAM_SUB_BITS)
+
+/**
+ * @brief A MoxieHistogram counts the latencies in nanoseconds of a mocked
+ * function in log-linear buckets, whose width is 1/8 of their power of two.
+ *
+ * The counts are only valid while the epoch matches the callEpoch of the
+ * MoxieState, such that a reset does not need to clear every histogram.
+ */
+typedef struct MoxieHistogram
+{
+    unsigned long epoch _M_CACHE_ALIGNED;
+    unsigned long counts[_M_HISTOGRAM_BUCKETS];
+} MoxieHistogram;
+
 /**
  * @brief A MoxieState describes the state of a mocked function.
+ *
+ * The mockFlag is a bitmask of the enabled modes (e.g. mock and spy). The
+ * configuration is only written by the API Functions, whereas the counters
+ * (from callCount onwards) are written upon calls; the counters start a cache
+ * line of their own, and every MoxieState is cache line aligned, such that
+ * the calls of one mocked function do not invalidate the configuration of
+ * another.
  */
 typedef struct MoxieState
 {
@@ -16,8 +583,59 @@ typedef struct MoxieState
     char *scope;
     void *callFunc;
     void *stubFunc;
+    const void *returnValues;
+    unsigned long returnCount;
+    MoxieRepeat returnRepeat;
+    void *realFunc;
+    unsigned long samplePeriod;
+    MoxieSampling sampleMode;
+    unsigned long sampleEpoch;
+    const MoxieInjection *injection;
+    const void *faultValue;
+    MoxieReplay replayMatch;
+    void *filter;
+    unsigned long expectSize;
+    unsigned long callCount _M_CACHE_ALIGNED;
+    unsigned long callEpoch;
+    unsigned long captureCount;
+    unsigned long returnCursor;
+    unsigned long sampleHits;
+    unsigned long sampleSkips;
+    unsigned long injectCursor;
+    unsigned long replayCursor;
+    unsigned long memoHits;
+    unsigned long memoMisses;
+    unsigned long expectCursor;
+    unsigned long expectPending;
+    unsigned long expectFailures;
 } MoxieState;
 
+/**
+ * @brief A MoxieRegistration describes a mocked function to the registry of
+ * all mocked functions in the executable.
+ *
+ * The MoxieRegistrations of every M_IMPLEMENT_MOCK are emitted into a
+ * dedicated linker section such that they form a single contiguous array.
+ *
+ * The parameters and returnKind describe the M_PARAM_* and M_RETURN_* of the
+ * mocked function to the shared Slow Path (see MOXIE_SHARED_SLOW_PATH); the
+ * parameters are NULL if the mocked function is not described.
+ */
+typedef struct MoxieRegistration
+{
+    const char *name;
+    MoxieState *state;
+    void *callFunc;
+    void *stubFunc;
+    void (*reset)(void);
+    void (*enable)(void);
+    const MoxieHistogram *histograms;
+    unsigned long histogramCount;
+    int *armed;
+    const char *parameters;
+    int returnKind;
+} MoxieRegistration;
+
 /*
  * API Functions:
  */
@@ -27,23 +645,29 @@ typedef struct MoxieState
  *
  * @example Moxie_reset(sqrt)();
  */
-#define Moxie_reset(FUNC) __mReset_#FUNC
+#define Moxie_reset(FUNC) __mReset_##FUNC
 
 /**
  * @brief Enables the CppUMock integration for the specified function.
  *
  * @example Moxie_enable(sqrt)();
  */
-#define Moxie_enable(FUNC) __mEnable_#FUNC
+#define Moxie_enable(FUNC) __mEnable_##FUNC
 
 /**
  * @brief Sets the CppUMock scope in which the mock expectations are tracked.
  *
  * @example Moxie_setScope(sqrt)("MATH");
  *
+ * @note The MockSupport_c of the scope is resolved upon every call rather than
+ * cached, because the CppUMock C interface returns the same MockSupport_c for
+ * every scope and binds the scope as a side effect of mock_c() and
+ * mock_scope_c(). A cached MockSupport_c would track the expectations of the
+ * most recently resolved scope instead.
+ *
  * @param scope the CppUMock scope
  */
-#define Moxie_setScope(FUNC) __mSetScope_#FUNC
+#define Moxie_setScope(FUNC) __mSetScope_##FUNC
 
 /**
  * @brief Overrides the callback function executed upon call.
@@ -60,7 +684,7 @@ typedef struct MoxieState
  *
  * @param callFunc a MoxieCallFunc_##FUNC callback function
  */
-#define Moxie_setCallFunc(FUNC) __mSetCallFunc_#FUNC
+#define Moxie_setCallFunc(FUNC) __mSetCallFunc_##FUNC
 
 /**
  * @brief Overrides the callback function executed upon return.
@@ -77,65 +701,456 @@ typedef struct MoxieState
  *
  * @param callFunc a MoxieStubFunc_##FUNC callback function
  */
-#define Moxie_setStubFunc(FUNC) __mSetStubFunc_#FUNC
+#define Moxie_setStubFunc(FUNC) __mSetStubFunc_##FUNC
 
-/*
- * API Macros:
+/**
+ * @brief Restricts the enabled modes of the specified function to the calls
+ * whose arguments satisfy the specified predicate.
+ *
+ * The predicate receives the arguments of the realFunc before the scope is
+ * resolved or any mode is processed, such that the other calls (e.g. the
+ * read()s of every other file descriptor) are forwarded to the realFunc as if
+ * no mode were enabled. The predicate may be evaluated more than once per
+ * call and must not have side effects.
+ *
+ * @code
+ * static int
+ * my_read_filter(int fd, void *buf, size_t count)
+ * {
+ *     return fd == 42;
+ * }
+ *
+ * Moxie_enable(read)();
+ * Moxie_setFilter(read)(my_read_filter);
+ * @endcode
+ *
+ * @param filter a MoxieFilterFunc_##FUNC predicate, or NULL to clear the
+ *        filter
  */
+#define Moxie_setFilter(FUNC) __mSetFilter_##FUNC
 
 /**
- * @brief Specifies for andReturnBoolValue() that a void function should exit
- * instead of invoking a stubFunc or a realFunc.
+ * @brief Counts the calls of the specified function without enabling the
+ * CppUMock integration.
  *
- * The necessity of this flag is exemplified by unconditional void functions
- * that set output parameters. Thus, if a developer configures an expectation
- * for an output parameter, but the underlying realFunc is executed, then the
- * underlying realFunc will override the configured expectation.
+ * The realFunc is still executed unless the CppUMock integration is also
+ * enabled. Every call increments a relaxed atomic counter and a counter of the
+ * calling thread.
+ *
+ * @example Moxie_spy(fsync)();
  */
-#define M_VOID_EXIT 0
+#define Moxie_spy(FUNC) __mSpy_##FUNC
 
 /**
- * @brief Notifies a GCC/Clang C compiler that the attributed function should
- * be emitted as a weak symbol rather than a global symbol.
+ * @brief Returns the number of calls of the specified function that have been
+ * counted by Moxie_spy(FUNC) since the last Moxie_reset(FUNC).
  *
- * @code
- * M_EXPORT_MOCK
- * extern double sqrt(double);
- * @endcode
+ * @example unsigned long calls = Moxie_callCount(fsync)();
  */
-#define M_EXPORT_MOCK __attribute__((weak))
+#define Moxie_callCount(FUNC) __mCallCount_##FUNC
 
 /**
- * @brief Returns the function identifier of the real implementation of FUNC.
+ * @brief Returns the number of calls of the specified function on the calling
+ * thread that have been counted by Moxie_spy(FUNC) since the last
+ * Moxie_reset(FUNC).
  *
- * @example M_REAL_FUNC(sqrt)(1.0);
+ * @example unsigned long calls = Moxie_threadCallCount(fsync)();
  */
-#define M_REAL_FUNC(FUNC) __real_##FUNC
+#define Moxie_threadCallCount(FUNC) __mThreadCallCount_##FUNC
 
 /**
- * @brief Returns the function identifier of the mocked implementation of FUNC.
+ * @brief Captures the arguments of every call of the specified function into
+ * its ring buffer without enabling the CppUMock integration.
  *
- * @example M_MOCK_FUNC(sqrt)(1.0);
+ * @note Only available if MOXIE_CAPTURE_CAPACITY is defined.
+ *
+ * @example Moxie_capture(send)();
  */
-#define M_MOCK_FUNC(FUNC) __wrap_##FUNC
+#define Moxie_capture(FUNC) __mCapture_##FUNC
 
 /**
- * @brief Declares the specified function is to be mocked.
+ * @brief Returns the captured arguments of a recent call of the specified
+ * function, where index 0 is the most recent call.
  *
- * @note It is recommended to organize all M_DECLARE_MOCK macro calls into a
- * centralized '.h' file.
- * @note M_RETURN_VOID and/or M_PARAM_VOID can be used as needed; if the
- * specified function does not accept any parameters, then M_PARAM_VOID must be
- * specified.
+ * @note Only available if MOXIE_CAPTURE_CAPACITY is defined.
  *
  * @code
- * M_DECLARE_MOCK(
- *     M_RETURN_DOUBLE(double),
- *     pow,
- *     M_PARAM_DOUBLE(double,x),
- *     M_PARAM_DOUBLE(double,y)
- * );
- * @endcode
+ * const MoxieArgs_send *args = Moxie_captured(send)(0);
+ * if (args != NULL)
+ * {
+ *     CHECK_EQUAL(42, args->sockfd);
+ * }
+ * @endcode
+ *
+ * @param index the number of calls preceding the most recent call
+ * @return the captured arguments, or NULL if the call was not captured or has
+ *         been overwritten
+ */
+#define Moxie_captured(FUNC) __mCaptured_##FUNC
+
+/**
+ * @brief Returns the number of calls of the specified function that have been
+ * captured since the last Moxie_reset(FUNC), including the calls that have
+ * since been overwritten.
+ *
+ * @note Only available if MOXIE_CAPTURE_CAPACITY is defined.
+ *
+ * @example unsigned long calls = Moxie_capturedCount(send)();
+ */
+#define Moxie_capturedCount(FUNC) __mCapturedCount_##FUNC
+
+/**
+ * @brief Records the latency of every call of the realFunc of the specified
+ * function into its histograms without enabling the CppUMock integration.
+ *
+ * The latency is measured with CLOCK_MONOTONIC_RAW where available. The calls
+ * that are stubbed (e.g. by a return sequence or a stubFunc) are not recorded.
+ *
+ * @note Only available if MOXIE_PROFILE_SHARDS is defined.
+ *
+ * @example Moxie_profile(fsync)();
+ */
+#define Moxie_profile(FUNC) __mProfile_##FUNC
+
+/**
+ * @brief Returns the number of calls of the specified function that have been
+ * recorded by Moxie_profile(FUNC) since the last Moxie_reset(FUNC).
+ *
+ * @note Only available if MOXIE_PROFILE_SHARDS is defined.
+ *
+ * @example unsigned long calls = Moxie_profileCount(fsync)();
+ */
+#define Moxie_profileCount(FUNC) __mProfileCount_##FUNC
+
+/**
+ * @brief Returns the specified quantile of the latencies in nanoseconds of the
+ * specified function that have been recorded by Moxie_profile(FUNC) since the
+ * last Moxie_reset(FUNC).
+ *
+ * The quantile is the upper bound of its bucket, such that it overestimates
+ * the latency by at most 12.5%.
+ *
+ * @note Only available if MOXIE_PROFILE_SHARDS is defined.
+ *
+ * @code
+ * unsigned long p50 = Moxie_profileQuantile(fsync)(0.5);
+ * unsigned long p99 = Moxie_profileQuantile(fsync)(0.99);
+ * unsigned long p999 = Moxie_profileQuantile(fsync)(0.999);
+ * @endcode
+ *
+ * @param quantile the quantile in [0, 1]
+ * @return the latency in nanoseconds, or 0 if no call has been recorded
+ */
+#define Moxie_profileQuantile(FUNC) __mProfileQuantile_##FUNC
+
+/**
+ * @brief Records every call of the specified function, i.e. its thread, start
+ * timestamp, and duration, as a MoxieTraceEvent for Moxie_dumpTrace() without
+ * enabling the CppUMock integration.
+ *
+ * The duration covers the Slow Path of the call, including the callFunc,
+ * stubFunc, or realFunc that it is deferred to.
+ *
+ * @note Only available if MOXIE_TRACE_CAPACITY is defined.
+ *
+ * @example Moxie_trace(fsync)();
+ */
+#define Moxie_trace(FUNC) __mTrace_##FUNC
+
+/**
+ * @brief Appends a MoxieRecord of every call of the realFunc of the specified
+ * function to the file of Moxie_startRecording() without enabling the
+ * CppUMock integration.
+ *
+ * The calls that are stubbed (e.g. by a return sequence or a stubFunc) are not
+ * recorded, whereas the calls that could not be replayed are.
+ *
+ * @note Only available if MOXIE_RECORD_REPLAY is defined.
+ *
+ * @example Moxie_record(getaddrinfo)();
+ */
+#define Moxie_record(FUNC) __mRecord_##FUNC
+
+/**
+ * @brief Serves every call of the realFunc of the specified function from the
+ * MoxieRecords of Moxie_startReplay() without calling the realFunc.
+ *
+ * The output parameters are overwritten by the recorded pointees, up to their
+ * sizes. A call without a matching MoxieRecord is deferred to the realFunc.
+ *
+ * @note Only available if MOXIE_RECORD_REPLAY is defined.
+ *
+ * @example Moxie_replay(getaddrinfo)(MOXIE_REPLAY_ARGUMENTS);
+ *
+ * @param match the MoxieReplay
+ */
+#define Moxie_replay(FUNC) __mReplay_##FUNC
+
+/**
+ * @brief Returns the cached results of the realFunc of the specified function
+ * for the arguments it has already been called with, instead of calling the
+ * realFunc again.
+ *
+ * Only the return value is cached, such that the function must be pure for
+ * its arguments. The calls that are stubbed (e.g. by a return sequence or a
+ * stubFunc) are not memoized, and Moxie_reset(FUNC) clears the cache.
+ *
+ * @note A function with an M_PARAM_IN_PTR, M_PARAM_OUT_PTR,
+ * M_PARAM_IN_TYPE_PTR, M_PARAM_OUT_TYPE_PTR, M_PARAM_OUT_BUFFER, or
+ * M_PARAM_CUSTOM is refused: the Assert fails and the function is left
+ * unmemoized, as those arguments are not hashed and those outputs would not be
+ * restored. The arguments of M_PARAM_IGNORE are not hashed either, and must
+ * not affect the result.
+ *
+ * @note Only available if MOXIE_MEMOIZE_CAPACITY is defined.
+ *
+ * @example Moxie_memoize(pow)();
+ */
+#define Moxie_memoize(FUNC) __mMemoize_##FUNC
+
+/**
+ * @brief Returns the number of memoized calls of the specified function that
+ * were served from its cache since the last Moxie_reset(FUNC).
+ *
+ * @note Only available if MOXIE_MEMOIZE_CAPACITY is defined.
+ *
+ * @example unsigned long hits = Moxie_memoHits(pow)();
+ */
+#define Moxie_memoHits(FUNC) __mMemoHits_##FUNC
+
+/**
+ * @brief Returns the number of memoized calls of the specified function that
+ * called the realFunc since the last Moxie_reset(FUNC).
+ *
+ * @note Only available if MOXIE_MEMOIZE_CAPACITY is defined.
+ *
+ * @example unsigned long misses = Moxie_memoMisses(pow)();
+ */
+#define Moxie_memoMisses(FUNC) __mMemoMisses_##FUNC
+
+/**
+ * @brief Enables the CppUMock integration for the specified function, of
+ * which the calls are appended to a preallocated log instead of being
+ * processed by actualCall() until Moxie_flushDeferred() or
+ * Moxie_checkExpectations() replays them.
+ *
+ * A deferred call is logged, then returns the next value of its return
+ * sequence, or the result of its stubFunc (which is invoked with NULL
+ * MockSupport_c and MockActualCall_c), or the result of the realFunc if the
+ * stubFunc is the default stubFunc, as the return values of the expectations
+ * are only known upon the replay. The calls that cannot be deferred (see
+ * MOXIE_DEFER_CAPACITY) flush the log, are processed at once, and still
+ * return the next value of the return sequence.
+ *
+ * @note Only available if MOXIE_DEFER_CAPACITY is defined.
+ *
+ * @code
+ * Moxie_defer(fsync)();
+ * Moxie_setReturnSequence(fsync)(results, 1, MOXIE_REPEAT_LAST);
+ * // ...
+ * Moxie_checkExpectations();
+ * @endcode
+ */
+#define Moxie_defer(FUNC) __mDefer_##FUNC
+
+/**
+ * @brief Returns the values of the specified array from the specified
+ * function, one value per call, without the CppUMock integration.
+ *
+ * The return sequence takes precedence over the CppUMock integration and the
+ * realFunc until it is exhausted. The array must outlive the return sequence,
+ * as it is not copied. For an M_RETURN_VOID function, each value of the
+ * sequence exits the function instead of invoking the realFunc. The calls of
+ * a function of Moxie_defer(FUNC) still reach CppUMock, as the value is only
+ * returned once the call is logged.
+ *
+ * @code
+ * static const ssize_t sizes[] = { 4, 4, 0 };
+ * Moxie_setReturnSequence(read)(sizes, 3, MOXIE_REPEAT_LAST);
+ * @endcode
+ *
+ * @param values an array of the return type of the specified function
+ * @param count the number of values in the array, or 0 to clear the sequence
+ * @param repeat the MoxieRepeat once every value has been returned
+ */
+#define Moxie_setReturnSequence(FUNC) __mSetReturnSequence_##FUNC
+
+/**
+ * @brief Routes only the sampled calls of the specified function through the
+ * other enabled modes (e.g. mock and spy).
+ *
+ * The unsampled calls are forwarded to the realFunc by the Fast Path, as if no
+ * mode were enabled, once they are counted down by the calling thread; the
+ * results of the sampled calls can be scaled by Moxie_sampleHits(FUNC) and
+ * Moxie_sampleSkips(FUNC). The filter of Moxie_setFilter(FUNC) is only
+ * evaluated by the sampled calls; a sampled call that is filtered out passes
+ * its sample on to the next call.
+ *
+ * @code
+ * Moxie_spy(malloc)();
+ * Moxie_setSampling(malloc)(1000, MOXIE_SAMPLE_PERIODIC);
+ * @endcode
+ *
+ * @param period the N of the MoxieSampling, or 0 or 1 to sample every call
+ * @param mode the MoxieSampling
+ */
+#define Moxie_setSampling(FUNC) __mSetSampling_##FUNC
+
+/**
+ * @brief Returns the number of sampled calls of the specified function since
+ * the last Moxie_reset(FUNC).
+ *
+ * @example unsigned long hits = Moxie_sampleHits(malloc)();
+ */
+#define Moxie_sampleHits(FUNC) __mSampleHits_##FUNC
+
+/**
+ * @brief Returns the number of unsampled calls of the specified function since
+ * the last Moxie_reset(FUNC).
+ *
+ * The unsampled calls of another thread are only counted once that thread
+ * makes its next sampled call.
+ *
+ * @example unsigned long skips = Moxie_sampleSkips(malloc)();
+ */
+#define Moxie_sampleSkips(FUNC) __mSampleSkips_##FUNC
+
+/**
+ * @brief Injects latency and faults in front of the realFunc of the specified
+ * function without the CppUMock integration.
+ *
+ * A faulted call returns the faultValue, or exits an M_RETURN_VOID function,
+ * instead of invoking the realFunc. The injection takes precedence over the
+ * return sequence and the CppUMock integration. The MoxieInjection and the
+ * faultValue must outlive the injection, as they are not copied.
+ *
+ * @note Without CLOCK_MONOTONIC (e.g. if POSIX is not enabled in the
+ * translation unit of M_IMPLEMENT_MOCK), the latency is busy-waited on the
+ * processor time of clock() regardless of the MoxieWait.
+ *
+ * @code
+ * static const MoxieInjection slowFsync = {
+ *     .wait = MOXIE_WAIT_SLEEP,
+ *     .latencyProbability = 0.01,
+ *     .latencyNs = 50000000,
+ *     .jitterNs = 10000000,
+ *     .faultProbability = 0.001,
+ *     .seed = 42,
+ * };
+ * static const int fsyncError = -1;
+ * Moxie_setInjection(fsync)(&slowFsync, &fsyncError);
+ * @endcode
+ *
+ * @param injection the MoxieInjection, or NULL to clear the injection
+ * @param faultValue a value of the return type of the specified function, or
+ *        NULL for an M_RETURN_VOID function
+ */
+#define Moxie_setInjection(FUNC) __mSetInjection_##FUNC
+
+/**
+ * @brief Publishes the configuration of the calling thread as the global
+ * configuration for the specified function.
+ *
+ * @note Only available if MOXIE_THREAD_LOCAL_STATE is defined.
+ * @note Threads that have not called an API Function for the specified
+ * function, or that have since called Moxie_reset(FUNC)(), are configured by
+ * the global configuration.
+ *
+ * @code
+ * Moxie_enable(sqrt)();
+ * Moxie_setStubFunc(sqrt)(my_sqrt_returnFunc);
+ * Moxie_publish(sqrt)();
+ * @endcode
+ */
+#define Moxie_publish(FUNC) __mPublish_##FUNC
+
+/**
+ * @brief Appends an expectation of the specified number of calls to the
+ * native expectations of the specified function (MOXIE_NATIVE_BACKEND only).
+ *
+ * The MoxieExpectation_##FUNC compares every parameter of the calls by
+ * default; the i-th parameter (from 0) is ignored by clearing the i-th bit of
+ * its withMask. The returnValue is returned once hasReturn is set; otherwise,
+ * the stubFunc defers to the realFunc.
+ *
+ * @code
+ * MoxieExpectation_pow *expectation = Moxie_expect(pow)(1);
+ * expectation->args.x = 2.0;
+ * expectation->withMask &= ~(1ul << 1);
+ * expectation->returnValue = 4.0;
+ * expectation->hasReturn = 1;
+ * @endcode
+ *
+ * @return the MoxieExpectation_##FUNC, or NULL if MOXIE_NATIVE_CAPACITY
+ *         expectations have already been appended since the last reset
+ */
+#define Moxie_expect(FUNC) __mExpect_##FUNC
+
+/**
+ * @brief Returns the number of unexpected calls and unmet expected calls of
+ * the specified function (MOXIE_NATIVE_BACKEND only).
+ *
+ * @example CHECK_EQUAL(0, Moxie_verify(pow)());
+ */
+#define Moxie_verify(FUNC) __mVerify_##FUNC
+
+/*
+ * API Macros:
+ */
+
+/**
+ * @brief Specifies for andReturnBoolValue() that a void function should exit
+ * instead of invoking a stubFunc or a realFunc.
+ *
+ * The necessity of this flag is exemplified by unconditional void functions
+ * that set output parameters. Thus, if a developer configures an expectation
+ * for an output parameter, but the underlying realFunc is executed, then the
+ * underlying realFunc will override the configured expectation.
+ */
+#define M_VOID_EXIT 0
+
+/**
+ * @brief Notifies a GCC/Clang C compiler that the attributed function should
+ * be emitted as a weak symbol rather than a global symbol.
+ *
+ * @code
+ * M_EXPORT_MOCK
+ * extern double sqrt(double);
+ * @endcode
+ */
+#define M_EXPORT_MOCK __attribute__((weak))
+
+/**
+ * @brief Returns the function identifier of the real implementation of FUNC.
+ *
+ * @example M_REAL_FUNC(sqrt)(1.0);
+ */
+#define M_REAL_FUNC(FUNC) __real_##FUNC
+
+/**
+ * @brief Returns the function identifier of the mocked implementation of FUNC.
+ *
+ * @example M_MOCK_FUNC(sqrt)(1.0);
+ */
+#define M_MOCK_FUNC(FUNC) __wrap_##FUNC
+
+/**
+ * @brief Declares the specified function is to be mocked.
+ *
+ * @note It is recommended to organize all M_DECLARE_MOCK macro calls into a
+ * centralized '.h' file.
+ * @note M_RETURN_VOID and/or M_PARAM_VOID can be used as needed; if the
+ * specified function does not accept any parameters, then M_PARAM_VOID must be
+ * specified.
+ *
+ * @code
+ * M_DECLARE_MOCK(
+ *     M_RETURN_DOUBLE(double),
+ *     pow,
+ *     M_PARAM_DOUBLE(double,x),
+ *     M_PARAM_DOUBLE(double,y)
+ * );
+ * @endcode
  *
  * @see "Type Macros" below for an overview of the supported Type Macros.
  *
@@ -175,6 +1190,70 @@ typedef struct MoxieState
  */
 #define M_IMPLEMENT_MOCK(RET,FUNC,...) _M_IMPLEMENT_MOCK(RET,FUNC,__VA_ARGS__)
 
+/**
+ * @brief Declares every function of the specified mock table is to be mocked.
+ *
+ * A mock table is an X-macro that applies its argument to the M_RETURN_* type,
+ * the function, and the M_PARAM_* types of every mocked function, such that
+ * M_DECLARE_MOCK_TABLE, M_IMPLEMENT_MOCK_TABLE, and M_WRAP_MOCK_TABLE are
+ * generated from a single source.
+ *
+ * @code
+ * #define FILE_MOCKS(X) \
+ *     X(M_RETURN_INT(int), open, M_PARAM_CHAR_PTR(const char *,path), M_PARAM_INT(int,flags)) \
+ *     X(M_RETURN_INT(int), close, M_PARAM_INT(int,fd))
+ *
+ * M_DECLARE_MOCK_TABLE(FILE_MOCKS)
+ * @endcode
+ *
+ * @param TABLE the identifier of the mock table
+ */
+#define M_DECLARE_MOCK_TABLE(TABLE) _M_DECLARE_MOCK_TABLE(TABLE)
+
+/**
+ * @brief Implements every function of the specified mock table as a mock.
+ *
+ * @note The MoxieStates and the MoxieRegistrations of the mock table are each
+ * a single array indexed by the position of the function in the table.
+ * @note A translation unit implements at most one mock table; a table of
+ * several tables (e.g. `#define ALL_MOCKS(X) FILE_MOCKS(X) NET_MOCKS(X)`)
+ * implements them together, and is declared as such.
+ *
+ * @example M_IMPLEMENT_MOCK_TABLE(FILE_MOCKS)
+ *
+ * @param TABLE the identifier of the mock table
+ */
+#define M_IMPLEMENT_MOCK_TABLE(TABLE) _M_IMPLEMENT_MOCK_TABLE(TABLE)
+
+/**
+ * @brief Returns a string literal of the `-Wl,--wrap=...` LDFLAGS of the
+ * specified mock table, separated by spaces.
+ *
+ * @note The LDFLAGS can be extracted by a build from the preprocessed output:
+ * @code
+ * printf '#include "file_mocks.h"\nM_WRAP_MOCK_TABLE(FILE_MOCKS)\n' | cc -E -P -I. - | tail -n 1 | tr -d '"'
+ * @endcode
+ *
+ * @param TABLE the identifier of the mock table
+ */
+#define M_WRAP_MOCK_TABLE(TABLE) _M_WRAP_MOCK_TABLE(TABLE)
+
+/**
+ * @brief Resets the CppUMock integration for every function of the specified
+ * mock table, as Moxie_resetAll() does for every mocked function.
+ *
+ * @example Moxie_resetTable(FILE_MOCKS)();
+ */
+#define Moxie_resetTable(TABLE) __mResetTable_##TABLE
+
+/**
+ * @brief Enables the CppUMock integration for every function of the specified
+ * mock table, as Moxie_enableAll() does for every mocked function.
+ *
+ * @example Moxie_enableTable(FILE_MOCKS)();
+ */
+#define Moxie_enableTable(TABLE) __mEnableTable_##TABLE
+
 /*
  * Type Macros:
  * These Type Macros are associated with the generalized types supported by
@@ -199,15 +1278,19 @@ typedef struct MoxieState
 #undef _OUT_PTR
 #undef _IN_TYPE_PTR
 #undef _OUT_TYPE_PTR
+#undef _BUFFER
+#undef _OUT_BUFFER
 #undef _IGNORE
 #undef _CUSTOM
 
 // Returns:
 // - M_RETURN_* macros are the public macros that capture the developer's
 //   description of the return type.
-// - For each M_RETURN_* macro, corresponding private _M_RETURN_TYPE_* and
-//   _M_RETURN_CALLBACK_* macros must be defined with identical arity between
-//   all 3 macros.
+// - For each M_RETURN_* macro, corresponding private _M_RETURN_TYPE_*,
+//   _M_RETURN_CALLBACK_*, _M_RETURN_KIND_*, and _M_RETURN_SHARED_* macros must
+//   be defined with identical arity between all 5 macros.
+// - _M_RETURN_KIND_* and _M_RETURN_SHARED_* describe the return to and receive
+//   the return from the shared Slow Path (see MOXIE_SHARED_SLOW_PATH).
 // - M_RETURN_VOID does not need any arguments to be specified.
 // - M_RETURN_CUSTOM can be utilized to specify custom code generation for the
 //   return.
@@ -222,7 +1305,7 @@ typedef struct MoxieState
 #define M_RETURN_PTR(PTYPE) _M_DEFER(_PTR)(PTYPE)
 #define M_RETURN_CUSTOM(PTYPE,...) _M_DEFER(_CUSTOM)(PTYPE,__VA_ARGS__)
 
-#define _M_RETURN_TYPE(RET) _M_RETURN_TYPE_##RET
+#define _M_RETURN_TYPE(RET) _M_RETURN_TYPE##RET
 #define _M_RETURN_TYPE_VOID void
 #define _M_RETURN_TYPE_BOOL(PTYPE) PTYPE
 #define _M_RETURN_TYPE_INT(PTYPE) PTYPE
@@ -234,7 +1317,7 @@ typedef struct MoxieState
 #define _M_RETURN_TYPE_PTR(PTYPE) PTYPE
 #define _M_RETURN_TYPE_CUSTOM(PTYPE,...) PTYPE
 
-#define _M_RETURN_CALLBACK(RET) _M_RETURN_CALLBACK_##RET
+#define _M_RETURN_CALLBACK(RET) _M_RETURN_CALLBACK##RET
 #define _M_RETURN_CALLBACK_VOID return;
 #define _M_RETURN_CALLBACK_BOOL(PTYPE) return (PTYPE) actualCall->boolReturnValue();
 #define _M_RETURN_CALLBACK_INT(PTYPE) return (PTYPE) actualCall->intReturnValue();
@@ -246,13 +1329,54 @@ typedef struct MoxieState
 #define _M_RETURN_CALLBACK_PTR(PTYPE) return (PTYPE) actualCall->pointerReturnValue();
 #define _M_RETURN_CALLBACK_CUSTOM(PTYPE,...) __VA_ARGS__
 
+#define _M_RETURN_KIND(RET) _M_RETURN_KIND##RET
+#define _M_RETURN_KIND_VOID _M_KIND_NONE
+#define _M_RETURN_KIND_BOOL(PTYPE) _M_KIND_BOOL
+#define _M_RETURN_KIND_INT(PTYPE) _M_KIND_INT
+#define _M_RETURN_KIND_UINT(PTYPE) _M_KIND_UINT
+#define _M_RETURN_KIND_LONG(PTYPE) _M_KIND_LONG
+#define _M_RETURN_KIND_ULONG(PTYPE) _M_KIND_ULONG
+#define _M_RETURN_KIND_DOUBLE(PTYPE) _M_KIND_DOUBLE
+#define _M_RETURN_KIND_CHAR_PTR(PTYPE) _M_KIND_CHAR_PTR
+#define _M_RETURN_KIND_PTR(PTYPE) _M_KIND_PTR
+#define _M_RETURN_KIND_CUSTOM(PTYPE,...) _M_KIND_CUSTOM
+
+#define _M_RETURN_SHARED(RET) _M_RETURN_SHARED##RET
+#define _M_RETURN_SHARED_VOID return;
+#define _M_RETURN_SHARED_BOOL(PTYPE) return (PTYPE) slow.result.i;
+#define _M_RETURN_SHARED_INT(PTYPE) return (PTYPE) slow.result.i;
+#define _M_RETURN_SHARED_UINT(PTYPE) return (PTYPE) slow.result.u;
+#define _M_RETURN_SHARED_LONG(PTYPE) return (PTYPE) slow.result.l;
+#define _M_RETURN_SHARED_ULONG(PTYPE) return (PTYPE) slow.result.ul;
+#define _M_RETURN_SHARED_DOUBLE(PTYPE) return (PTYPE) slow.result.d;
+#define _M_RETURN_SHARED_CHAR_PTR(PTYPE) return (PTYPE) slow.result.s;
+#define _M_RETURN_SHARED_PTR(PTYPE) return (PTYPE) slow.result.p;
+#define _M_RETURN_SHARED_CUSTOM(PTYPE,...) /* N/A. */
+
 // Parameters:
 // - M_PARAM_* macros are the public macros that capture the developer's
 // description of the parameter types.
 // - For each M_PARAM_* macro, corresponding private _M_PARAM_TYPE_*,
-//   _M_PARAM_NAME_*, and _M_PARAM_CALLBACK_* macros must be defined with
-//   identical arity between all 4 macros.
+//   _M_PARAM_NAME_*, _M_PARAM_CALLBACK_*, _M_PARAM_MATCH_*,
+//   _M_PARAM_DESCRIPTOR_*, _M_PARAM_PACK_*, _M_PARAM_HASH_*, and
+//   _M_PARAM_OUTPUT_* macros must be defined with identical arity between all 9
+//   macros.
+// - _M_PARAM_MATCH_* compares the parameter to the args of the expectation of
+//   the native backend.
+// - _M_PARAM_DESCRIPTOR_* describes the parameter to the shared Slow Path as a
+//   string literal of its _M_KIND_* byte, its type (M_PARAM_*_TYPE_PTR only),
+//   and its name, and _M_PARAM_PACK_* packs the argument into one MoxieValue
+//   for it (or two for M_PARAM_BUFFER, whose LEN_PARAM follows the pointer).
+// - _M_PARAM_HASH_* mixes the argument into the hash of the arguments of a
+//   MoxieRecord or a memoized call, and _M_PARAM_OUTPUT_* describes the
+//   pointee of an output parameter as a MoxieOutput (see MOXIE_RECORD_REPLAY
+//   and MOXIE_MEMOIZE_CAPACITY).
 // - M_PARAM_VOID does not need any arguments to be specified.
+// - M_PARAM_BUFFER compares the memory buffer of the parameter, whose size in
+//   bytes is given by LEN_PARAM (e.g. the name of a sibling parameter), rather
+//   than the pointer itself.
+// - M_PARAM_OUT_BUFFER is an M_PARAM_OUT_PTR whose pointee is LEN_PARAM bytes,
+//   e.g. the buffer of read(), for MOXIE_RECORD_REPLAY.
 // - M_PARAM_IGNORE can be utilized to ignore code generation for the specified
 //   parameter.
 // - M_PARAM_CUSTOM can be utilized to specify custom code generation for the
@@ -271,6 +1395,8 @@ typedef struct MoxieState
 #define M_PARAM_OUT_PTR(PTYPE,PNAME) _M_DEFER(_OUT_PTR)(PTYPE,PNAME)
 #define M_PARAM_IN_TYPE_PTR(PTYPE,PNAME) _M_DEFER(_IN_TYPE_PTR)(PTYPE,PNAME)
 #define M_PARAM_OUT_TYPE_PTR(PTYPE,PNAME) _M_DEFER(_OUT_TYPE_PTR)(PTYPE,PNAME)
+#define M_PARAM_BUFFER(PTYPE,PNAME,LEN_PARAM) _M_DEFER(_BUFFER)(PTYPE,PNAME,LEN_PARAM)
+#define M_PARAM_OUT_BUFFER(PTYPE,PNAME,LEN_PARAM) _M_DEFER(_OUT_BUFFER)(PTYPE,PNAME,LEN_PARAM)
 #define M_PARAM_IGNORE(PTYPE,PNAME) _M_DEFER(_IGNORE)(PTYPE,PNAME)
 #define M_PARAM_CUSTOM(PTYPE,PNAME,...) _M_DEFER(_CUSTOM)(PTYPE,PNAME,__VA_ARGS__)
 
@@ -289,6 +1415,8 @@ typedef struct MoxieState
 #define _M_PARAM_TYPE_OUT_PTR(PTYPE,PNAME) PTYPE
 #define _M_PARAM_TYPE_IN_TYPE_PTR(PTYPE,PNAME) PTYPE
 #define _M_PARAM_TYPE_OUT_TYPE_PTR(PTYPE,PNAME) PTYPE
+#define _M_PARAM_TYPE_BUFFER(PTYPE,PNAME,LEN_PARAM) PTYPE
+#define _M_PARAM_TYPE_OUT_BUFFER(PTYPE,PNAME,LEN_PARAM) PTYPE
 #define _M_PARAM_TYPE_IGNORE(PTYPE,PNAME) PTYPE
 #define _M_PARAM_TYPE_CUSTOM(PTYPE,PNAME,...) PTYPE
 
@@ -307,227 +1435,3775 @@ typedef struct MoxieState
 #define _M_PARAM_NAME_OUT_PTR(PTYPE,PNAME) PNAME
 #define _M_PARAM_NAME_IN_TYPE_PTR(PTYPE,PNAME) PNAME
 #define _M_PARAM_NAME_OUT_TYPE_PTR(PTYPE,PNAME) PNAME
+#define _M_PARAM_NAME_BUFFER(PTYPE,PNAME,LEN_PARAM) PNAME
+#define _M_PARAM_NAME_OUT_BUFFER(PTYPE,PNAME,LEN_PARAM) PNAME
 #define _M_PARAM_NAME_IGNORE(PTYPE,PNAME) PNAME
 #define _M_PARAM_NAME_CUSTOM(PTYPE,PNAME,...) PNAME
 
-#define _M_PARAM_CALLBACK(P) _M_PARAM_CALLBACK##P
-#define _M_PARAM_CALLBACK_VOID(PTYPE,PNAME) /* N/A. */
-#define _M_PARAM_CALLBACK_MS(PTYPE,PNAME) /* N/A. */
-#define _M_PARAM_CALLBACK_MAC(PTYPE,PNAME) /* N/A. */
-#define _M_PARAM_CALLBACK_BOOL(PTYPE,PNAME) actualCall->withBoolParameters(_M_STR(PNAME),PNAME);
-#define _M_PARAM_CALLBACK_INT(PTYPE,PNAME) actualCall->withIntParameters(_M_STR(PNAME),PNAME);
-#define _M_PARAM_CALLBACK_UINT(PTYPE,PNAME) actualCall->withUnsignedIntParameters(_M_STR(PNAME),PNAME);
-#define _M_PARAM_CALLBACK_LONG(PTYPE,PNAME) actualCall->withLongIntParameters(_M_STR(PNAME),PNAME);
-#define _M_PARAM_CALLBACK_ULONG(PTYPE,PNAME) actualCall->withUnsignedLongIntParameters(_M_STR(PNAME),PNAME);
-#define _M_PARAM_CALLBACK_DOUBLE(PTYPE,PNAME) actualCall->withDoubleParameters(_M_STR(PNAME),PNAME);
-#define _M_PARAM_CALLBACK_CHAR_PTR(PTYPE,PNAME) actualCall->withStringParameters(_M_STR(PNAME),PNAME);
-#define _M_PARAM_CALLBACK_IN_PTR(PTYPE,PNAME) actualCall->withPointerParameters(_M_STR(PNAME),PNAME);
-#define _M_PARAM_CALLBACK_OUT_PTR(PTYPE,PNAME) actualCall->withOutputParameter(_M_STR(PNAME),PNAME);
-#define _M_PARAM_CALLBACK_IN_TYPE_PTR(PTYPE,PNAME) actualCall->withParameterOfType(_M_STR(PTYPE),_M_STR(PNAME),PNAME);
-#define _M_PARAM_CALLBACK_OUT_TYPE_PTR(PTYPE,PNAME) actualCall->withOutputParameterOfType(_M_STR(PTYPE),_M_STR(PNAME),PNAME);
-#define _M_PARAM_CALLBACK_IGNORE(PTYPE,PNAME) /* N/A. */
-#define _M_PARAM_CALLBACK_CUSTOM(PTYPE,PNAME,...) __VA_ARGS__
+#define _M_PARAM_CALLBACK(P) _M_PARAM_CALLBACK##P
+#define _M_PARAM_CALLBACK_VOID(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_CALLBACK_MS(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_CALLBACK_MAC(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_CALLBACK_BOOL(PTYPE,PNAME) actualCall->withBoolParameters(_M_STR(PNAME),PNAME);
+#define _M_PARAM_CALLBACK_INT(PTYPE,PNAME) actualCall->withIntParameters(_M_STR(PNAME),PNAME);
+#define _M_PARAM_CALLBACK_UINT(PTYPE,PNAME) actualCall->withUnsignedIntParameters(_M_STR(PNAME),PNAME);
+#define _M_PARAM_CALLBACK_LONG(PTYPE,PNAME) actualCall->withLongIntParameters(_M_STR(PNAME),PNAME);
+#define _M_PARAM_CALLBACK_ULONG(PTYPE,PNAME) actualCall->withUnsignedLongIntParameters(_M_STR(PNAME),PNAME);
+#define _M_PARAM_CALLBACK_DOUBLE(PTYPE,PNAME) actualCall->withDoubleParameters(_M_STR(PNAME),PNAME);
+#define _M_PARAM_CALLBACK_CHAR_PTR(PTYPE,PNAME) actualCall->withStringParameters(_M_STR(PNAME),PNAME);
+#define _M_PARAM_CALLBACK_IN_PTR(PTYPE,PNAME) actualCall->withPointerParameters(_M_STR(PNAME),PNAME);
+#define _M_PARAM_CALLBACK_OUT_PTR(PTYPE,PNAME) actualCall->withOutputParameter(_M_STR(PNAME),PNAME);
+#define _M_PARAM_CALLBACK_IN_TYPE_PTR(PTYPE,PNAME) actualCall->withParameterOfType(_M_STR(PTYPE),_M_STR(PNAME),PNAME);
+#define _M_PARAM_CALLBACK_OUT_TYPE_PTR(PTYPE,PNAME) actualCall->withOutputParameterOfType(_M_STR(PTYPE),_M_STR(PNAME),PNAME);
+#define _M_PARAM_CALLBACK_BUFFER(PTYPE,PNAME,LEN_PARAM) actualCall->withMemoryBufferParameter(_M_STR(PNAME),(const unsigned char *)(PNAME),(size_t)(LEN_PARAM));
+#define _M_PARAM_CALLBACK_OUT_BUFFER(PTYPE,PNAME,LEN_PARAM) actualCall->withOutputParameter(_M_STR(PNAME),PNAME);
+#define _M_PARAM_CALLBACK_IGNORE(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_CALLBACK_CUSTOM(PTYPE,PNAME,...) __VA_ARGS__
+
+#define _M_PARAM_MATCH(P) _M_PARAM_MATCH##P
+#define _M_PARAM_MATCH_VOID(PTYPE,PNAME) 1
+#define _M_PARAM_MATCH_MS(PTYPE,PNAME) 1
+#define _M_PARAM_MATCH_MAC(PTYPE,PNAME) 1
+#define _M_PARAM_MATCH_BOOL(PTYPE,PNAME) (!expectation->args.PNAME == !PNAME)
+#define _M_PARAM_MATCH_INT(PTYPE,PNAME) (expectation->args.PNAME == PNAME)
+#define _M_PARAM_MATCH_UINT(PTYPE,PNAME) (expectation->args.PNAME == PNAME)
+#define _M_PARAM_MATCH_LONG(PTYPE,PNAME) (expectation->args.PNAME == PNAME)
+#define _M_PARAM_MATCH_ULONG(PTYPE,PNAME) (expectation->args.PNAME == PNAME)
+#define _M_PARAM_MATCH_DOUBLE(PTYPE,PNAME) (expectation->args.PNAME == PNAME)
+#define _M_PARAM_MATCH_CHAR_PTR(PTYPE,PNAME) __mMatchString(expectation->args.PNAME,PNAME)
+#define _M_PARAM_MATCH_IN_PTR(PTYPE,PNAME) (expectation->args.PNAME == PNAME)
+#define _M_PARAM_MATCH_OUT_PTR(PTYPE,PNAME) 1
+#define _M_PARAM_MATCH_IN_TYPE_PTR(PTYPE,PNAME) (expectation->args.PNAME == PNAME)
+#define _M_PARAM_MATCH_OUT_TYPE_PTR(PTYPE,PNAME) 1
+#define _M_PARAM_MATCH_BUFFER(PTYPE,PNAME,LEN_PARAM) __mMatchBuffer(expectation->args.PNAME,(unsigned long)(expectation->args.LEN_PARAM),PNAME,(unsigned long)(LEN_PARAM))
+#define _M_PARAM_MATCH_OUT_BUFFER(PTYPE,PNAME,LEN_PARAM) 1
+#define _M_PARAM_MATCH_IGNORE(PTYPE,PNAME) 1
+#define _M_PARAM_MATCH_CUSTOM(PTYPE,PNAME,...) 1
+
+#define _M_PARAM_DESCRIPTOR(P) _M_PARAM_DESCRIPTOR##P
+#define _M_PARAM_DESCRIPTOR_VOID(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_DESCRIPTOR_MS(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_DESCRIPTOR_MAC(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_DESCRIPTOR_BOOL(PTYPE,PNAME) "\1" _M_STR(PNAME) "\0"
+#define _M_PARAM_DESCRIPTOR_INT(PTYPE,PNAME) "\2" _M_STR(PNAME) "\0"
+#define _M_PARAM_DESCRIPTOR_UINT(PTYPE,PNAME) "\3" _M_STR(PNAME) "\0"
+#define _M_PARAM_DESCRIPTOR_LONG(PTYPE,PNAME) "\4" _M_STR(PNAME) "\0"
+#define _M_PARAM_DESCRIPTOR_ULONG(PTYPE,PNAME) "\5" _M_STR(PNAME) "\0"
+#define _M_PARAM_DESCRIPTOR_DOUBLE(PTYPE,PNAME) "\6" _M_STR(PNAME) "\0"
+#define _M_PARAM_DESCRIPTOR_CHAR_PTR(PTYPE,PNAME) "\7" _M_STR(PNAME) "\0"
+#define _M_PARAM_DESCRIPTOR_IN_PTR(PTYPE,PNAME) "\10" _M_STR(PNAME) "\0"
+#define _M_PARAM_DESCRIPTOR_OUT_PTR(PTYPE,PNAME) "\11" _M_STR(PNAME) "\0"
+#define _M_PARAM_DESCRIPTOR_IN_TYPE_PTR(PTYPE,PNAME) "\12" _M_STR(PTYPE) "\0" _M_STR(PNAME) "\0"
+#define _M_PARAM_DESCRIPTOR_OUT_TYPE_PTR(PTYPE,PNAME) "\13" _M_STR(PTYPE) "\0" _M_STR(PNAME) "\0"
+#define _M_PARAM_DESCRIPTOR_BUFFER(PTYPE,PNAME,LEN_PARAM) "\14" _M_STR(PNAME) "\0"
+#define _M_PARAM_DESCRIPTOR_OUT_BUFFER(PTYPE,PNAME,LEN_PARAM) "\11" _M_STR(PNAME) "\0"
+#define _M_PARAM_DESCRIPTOR_IGNORE(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_DESCRIPTOR_CUSTOM(PTYPE,PNAME,...) "\15" _M_STR(PNAME) "\0"
+
+#define _M_PARAM_PACK(P) _M_PARAM_PACK##P
+#define _M_PARAM_PACK_VOID(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_PACK_MS(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_PACK_MAC(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_PACK_BOOL(PTYPE,PNAME) { .i = (int)(PNAME) },
+#define _M_PARAM_PACK_INT(PTYPE,PNAME) { .i = (int)(PNAME) },
+#define _M_PARAM_PACK_UINT(PTYPE,PNAME) { .u = (unsigned int)(PNAME) },
+#define _M_PARAM_PACK_LONG(PTYPE,PNAME) { .l = (long)(PNAME) },
+#define _M_PARAM_PACK_ULONG(PTYPE,PNAME) { .ul = (unsigned long)(PNAME) },
+#define _M_PARAM_PACK_DOUBLE(PTYPE,PNAME) { .d = (double)(PNAME) },
+#define _M_PARAM_PACK_CHAR_PTR(PTYPE,PNAME) { .s = (const char *)(PNAME) },
+#define _M_PARAM_PACK_IN_PTR(PTYPE,PNAME) { .p = (const void *)(PNAME) },
+#define _M_PARAM_PACK_OUT_PTR(PTYPE,PNAME) { .p = (const void *)(PNAME) },
+#define _M_PARAM_PACK_IN_TYPE_PTR(PTYPE,PNAME) { .p = (const void *)(PNAME) },
+#define _M_PARAM_PACK_OUT_TYPE_PTR(PTYPE,PNAME) { .p = (const void *)(PNAME) },
+#define _M_PARAM_PACK_BUFFER(PTYPE,PNAME,LEN_PARAM) { .p = (const void *)(PNAME) }, { .ul = (unsigned long)(LEN_PARAM) },
+#define _M_PARAM_PACK_OUT_BUFFER(PTYPE,PNAME,LEN_PARAM) { .p = (const void *)(PNAME) },
+#define _M_PARAM_PACK_IGNORE(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_PACK_CUSTOM(PTYPE,PNAME,...) /* N/A. */
+
+#define _M_PARAM_HASH(P) _M_PARAM_HASH##P
+#define _M_PARAM_HASH_VOID(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_HASH_MS(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_HASH_MAC(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_HASH_BOOL(PTYPE,PNAME) arguments = __mHash(arguments, &(PNAME), sizeof(PNAME));
+#define _M_PARAM_HASH_INT(PTYPE,PNAME) arguments = __mHash(arguments, &(PNAME), sizeof(PNAME));
+#define _M_PARAM_HASH_UINT(PTYPE,PNAME) arguments = __mHash(arguments, &(PNAME), sizeof(PNAME));
+#define _M_PARAM_HASH_LONG(PTYPE,PNAME) arguments = __mHash(arguments, &(PNAME), sizeof(PNAME));
+#define _M_PARAM_HASH_ULONG(PTYPE,PNAME) arguments = __mHash(arguments, &(PNAME), sizeof(PNAME));
+#define _M_PARAM_HASH_DOUBLE(PTYPE,PNAME) arguments = __mHash(arguments, &(PNAME), sizeof(PNAME));
+#define _M_PARAM_HASH_CHAR_PTR(PTYPE,PNAME) arguments = __mHashString(arguments, PNAME);
+#define _M_PARAM_HASH_IN_PTR(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_HASH_OUT_PTR(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_HASH_IN_TYPE_PTR(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_HASH_OUT_TYPE_PTR(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_HASH_BUFFER(PTYPE,PNAME,LEN_PARAM) arguments = __mHash(arguments, PNAME, (size_t)(LEN_PARAM));
+#define _M_PARAM_HASH_OUT_BUFFER(PTYPE,PNAME,LEN_PARAM) /* N/A. */
+#define _M_PARAM_HASH_IGNORE(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_HASH_CUSTOM(PTYPE,PNAME,...) /* N/A. */
+
+#define _M_PARAM_OUTPUT(P) _M_PARAM_OUTPUT##P
+#define _M_PARAM_OUTPUT_VOID(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_OUTPUT_MS(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_OUTPUT_MAC(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_OUTPUT_BOOL(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_OUTPUT_INT(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_OUTPUT_UINT(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_OUTPUT_LONG(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_OUTPUT_ULONG(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_OUTPUT_DOUBLE(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_OUTPUT_CHAR_PTR(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_OUTPUT_IN_PTR(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_OUTPUT_OUT_PTR(PTYPE,PNAME) { (void *)(PNAME), _M_POINTEE_SIZE(PNAME) },
+#define _M_PARAM_OUTPUT_IN_TYPE_PTR(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_OUTPUT_OUT_TYPE_PTR(PTYPE,PNAME) { (void *)(PNAME), _M_POINTEE_SIZE(PNAME) },
+#define _M_PARAM_OUTPUT_BUFFER(PTYPE,PNAME,LEN_PARAM) /* N/A. */
+#define _M_PARAM_OUTPUT_OUT_BUFFER(PTYPE,PNAME,LEN_PARAM) { (void *)(PNAME), (size_t)(LEN_PARAM) },
+#define _M_PARAM_OUTPUT_IGNORE(PTYPE,PNAME) /* N/A. */
+#define _M_PARAM_OUTPUT_CUSTOM(PTYPE,PNAME,...) /* N/A. */
+
+/*
+ * Implementation Macros:
+ */
+
+#ifndef Assert
+#define Assert(c,...)
+#endif
+
+// State Accessors:
+// - Every read and write of a MoxieState field must be performed through these
+//   macros such that MOXIE_ATOMIC_STATE can substitute atomic accesses.
+// - _M_STATE_LOAD_RELAXED is reserved for the Fast Path and for reads that do
+//   not publish any other field.
+// - The GCC/Clang __atomic builtins implement the C11 memory model while
+//   remaining available in C99 and C++ translation units.
+#ifdef MOXIE_ATOMIC_STATE
+#define _M_STATE_LOAD_RELAXED(FIELD) __atomic_load_n(&(FIELD),__ATOMIC_RELAXED)
+#define _M_STATE_LOAD(FIELD) __atomic_load_n(&(FIELD),__ATOMIC_ACQUIRE)
+#define _M_STATE_STORE(FIELD,VALUE) __atomic_store_n(&(FIELD),(VALUE),__ATOMIC_RELEASE)
+#define _M_STATE_EXCHANGE(FIELD,VALUE) __atomic_exchange_n(&(FIELD),(VALUE),__ATOMIC_ACQ_REL)
+#else
+#define _M_STATE_LOAD_RELAXED(FIELD) (FIELD)
+#define _M_STATE_LOAD(FIELD) (FIELD)
+#define _M_STATE_STORE(FIELD,VALUE) ((FIELD) = (VALUE))
+#define _M_STATE_EXCHANGE(FIELD,VALUE) __mExchangeFlag(&(FIELD),(VALUE))
+#endif
+
+/**
+ * @brief Replaces the specified mockFlag.
+ *
+ * @return the replaced mockFlag
+ */
+static inline int
+__mExchangeFlag(int *field, int value)
+{
+    int previous = *field;
+    *field = value;
+    return previous;
+}
+
+// Environment Variables:
+#define _M_DISPATCH_ENV "MOXIE_ARMED"
+#define _M_ENABLE_ENV "MOXIE_ENABLE"
+
+// Flags:
+// - Each mode of a mocked function is a bit of the mockFlag of its MoxieState.
+#define _M_FLAG_MOCK 0x1
+#define _M_FLAG_SPY 0x2
+#define _M_FLAG_CAPTURE 0x4
+#define _M_FLAG_RETURN 0x8
+#define _M_FLAG_SAMPLE 0x10
+#define _M_FLAG_INJECT 0x20
+#define _M_FLAG_PROFILE 0x40
+#define _M_FLAG_TRACE 0x80
+#define _M_FLAG_RECORD 0x100
+#define _M_FLAG_REPLAY 0x200
+#define _M_FLAG_MEMOIZE 0x400
+#define _M_FLAG_DEFER 0x800
+
+// Kinds:
+// - The parameters and return of a mocked function are described by the kinds
+//   of their M_PARAM_* and M_RETURN_*, whereas M_PARAM_VOID, M_PARAM_MS,
+//   M_PARAM_MAC, and M_PARAM_IGNORE are not described.
+// - The escapes of _M_PARAM_DESCRIPTOR_* must match these values.
+#define _M_KIND_NONE 0
+#define _M_KIND_BOOL 1
+#define _M_KIND_INT 2
+#define _M_KIND_UINT 3
+#define _M_KIND_LONG 4
+#define _M_KIND_ULONG 5
+#define _M_KIND_DOUBLE 6
+#define _M_KIND_CHAR_PTR 7
+#define _M_KIND_PTR 8
+#define _M_KIND_OUT_PTR 9
+#define _M_KIND_IN_TYPE_PTR 10
+#define _M_KIND_OUT_TYPE_PTR 11
+#define _M_KIND_BUFFER 12
+#define _M_KIND_CUSTOM 13
+
+// - _M_STATE_RESET_STATISTICS only resets the counters that are reported
+//   (e.g. by Moxie_callCount(FUNC)), whereas _M_STATE_RESET_COUNTERS also
+//   rewinds the cursors of the configuration.
+#define _M_STATE_RESET_STATISTICS(STATE) \
+do \
+{ \
+    __atomic_store_n(&(STATE)->callCount, 0, __ATOMIC_RELAXED); \
+    __atomic_add_fetch(&(STATE)->callEpoch, 1, __ATOMIC_RELAXED); \
+    __atomic_store_n(&(STATE)->captureCount, 0, __ATOMIC_RELAXED); \
+    __atomic_add_fetch(&(STATE)->sampleEpoch, 1, __ATOMIC_RELAXED); \
+    __atomic_store_n(&(STATE)->sampleHits, 0, __ATOMIC_RELAXED); \
+    __atomic_store_n(&(STATE)->sampleSkips, 0, __ATOMIC_RELAXED); \
+    __atomic_store_n(&(STATE)->memoHits, 0, __ATOMIC_RELAXED); \
+    __atomic_store_n(&(STATE)->memoMisses, 0, __ATOMIC_RELAXED); \
+} while (0)
+
+#define _M_STATE_RESET_COUNTERS(STATE) \
+do \
+{ \
+    _M_STATE_RESET_STATISTICS(STATE); \
+    __atomic_store_n(&(STATE)->injectCursor, 0, __ATOMIC_RELAXED); \
+    __atomic_store_n(&(STATE)->replayCursor, 0, __ATOMIC_RELAXED); \
+    (STATE)->expectSize = 0; \
+    (STATE)->expectCursor = 0; \
+    (STATE)->expectPending = 0; \
+    (STATE)->expectFailures = 0; \
+} while (0)
+
+#define _M_STATE_RESET(STATE,CALLFUNC,STUBFUNC) \
+do \
+{ \
+    _M_STATE_STORE((STATE)->scope, (char *)""); \
+    _M_STATE_STORE((STATE)->callFunc, (void *)(CALLFUNC)); \
+    _M_STATE_STORE((STATE)->stubFunc, (void *)(STUBFUNC)); \
+    _M_STATE_STORE((STATE)->returnValues, NULL); \
+    _M_STATE_STORE((STATE)->returnCount, 0); \
+    _M_STATE_STORE((STATE)->returnCursor, 0); \
+    _M_STATE_STORE((STATE)->returnRepeat, MOXIE_REPEAT_NONE); \
+    _M_STATE_STORE((STATE)->samplePeriod, 0); \
+    _M_STATE_STORE((STATE)->sampleMode, MOXIE_SAMPLE_PERIODIC); \
+    __atomic_add_fetch(&(STATE)->sampleEpoch, 1, __ATOMIC_RELAXED); \
+    _M_STATE_STORE((STATE)->injection, NULL); \
+    _M_STATE_STORE((STATE)->faultValue, NULL); \
+    _M_STATE_STORE((STATE)->replayMatch, MOXIE_REPLAY_ORDER); \
+    _M_STATE_STORE((STATE)->filter, NULL); \
+} while (0)
+
+// - __mThreadInternal is set while Moxie itself calls into the C library (e.g.
+//   clock_gettime() for profiling, tracing, and injected latency), such that a
+//   mocked C library function reaches its realFunc rather than recursing into
+//   its own Slow Path.
+__thread int __mThreadInternal __attribute__((weak,visibility("hidden"))) = 0;
+
+/**
+ * @brief Returns whether the specified parameters describe a parameter of the
+ * specified kind.
+ *
+ * The parameters are walked kind by kind, as the type and the name of every
+ * parameter are terminated by a NUL.
+ */
+static inline int
+__mHasParameter(const char *parameter, int kind)
+{
+    while (*parameter != _M_KIND_NONE)
+    {
+        int next = *parameter++;
+        if (next == kind)
+        {
+            return 1;
+        }
+        if (next == _M_KIND_IN_TYPE_PTR || next == _M_KIND_OUT_TYPE_PTR)
+        {
+            parameter += strlen(parameter) + 1;
+        }
+        parameter += strlen(parameter) + 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Counts a call of the specified global MoxieState upon the specified
+ * MoxieCounter of the calling thread.
+ */
+static inline void
+__mSpyCount(MoxieState *global, MoxieCounter *counter)
+{
+    unsigned long epoch = __atomic_load_n(&global->callEpoch, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&global->callCount, 1, __ATOMIC_RELAXED);
+    if (counter->epoch != epoch)
+    {
+        counter->epoch = epoch;
+        counter->count = 0;
+    }
+    ++counter->count;
+}
+
+/**
+ * @brief Claims the index of the next value of the return sequence of the
+ * specified MoxieState.
+ *
+ * @return 1 if a value was claimed or 0 if the return sequence is exhausted
+ */
+static inline int
+__mNextReturn(MoxieState *state, unsigned long *index)
+{
+    unsigned long count = _M_STATE_LOAD(state->returnCount);
+    unsigned long cursor = __atomic_fetch_add(&state->returnCursor, 1, __ATOMIC_RELAXED);
+    if (cursor < count)
+    {
+        *index = cursor;
+        return 1;
+    }
+    switch (_M_STATE_LOAD_RELAXED(state->returnRepeat))
+    {
+    case MOXIE_REPEAT_LAST:
+        *index = count - 1;
+        return count != 0;
+    case MOXIE_REPEAT_CYCLE:
+        *index = (count != 0) ? (cursor % count) : 0;
+        return count != 0;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Advances the xorshift generator of the calling thread.
+ *
+ * The generator is seeded by the address of its thread-local state, such that
+ * every thread draws a distinct sequence without a shared cursor.
+ */
+static inline unsigned long
+__mSampleRandom(void)
+{
+    static __thread unsigned long long seed = 0;
+    unsigned long long x = seed;
+    if (x == 0)
+    {
+        x = (unsigned long long)(size_t)&seed | 1ull;
+    }
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    seed = x;
+    return (unsigned long)(x >> 11);
+}
+
+/**
+ * @brief Draws the number of unsampled calls before the next sampled call of
+ * the specified period of MOXIE_SAMPLE_RANDOM.
+ */
+static inline unsigned long
+__mSampleMisses(unsigned long period)
+{
+    unsigned long misses = 0;
+    while ((__mSampleRandom() % period) != 0)
+    {
+        ++misses;
+    }
+    return misses;
+}
+
+/**
+ * @brief Skips a call of the Fast Path upon the specified MoxieSampler of the
+ * calling thread, once its countdown is set.
+ *
+ * @return 1 if the call is skipped or 0 if the countdown is stale
+ */
+static inline int
+__mSampleSkip(MoxieSampler *sampler, const MoxieState *state)
+{
+    if (sampler->state == state && sampler->epoch == __atomic_load_n(&state->sampleEpoch, __ATOMIC_RELAXED))
+    {
+        --sampler->countdown;
+        return 1;
+    }
+    sampler->countdown = 0;
+    return 0;
+}
+
+/**
+ * @brief Returns the skips of the specified MoxieSampler of the calling thread
+ * that are yet to be published.
+ */
+static inline unsigned long
+__mSamplePending(const MoxieSampler *sampler)
+{
+    if (sampler->state != NULL && sampler->epoch == __atomic_load_n(&sampler->state->sampleEpoch, __ATOMIC_RELAXED))
+    {
+        return sampler->drawn - sampler->countdown;
+    }
+    return 0;
+}
+
+/**
+ * @brief Decides whether a call of the Slow Path is sampled by the specified
+ * (global or thread-local) MoxieState, and publishes the hits and skips of
+ * the specified MoxieSampler of the calling thread to the global MoxieState.
+ *
+ * The call that exhausts the countdown is sampled and draws the next
+ * countdown, such that the unsampled calls remain on the Fast Path.
+ *
+ * @return 1 if the call is sampled or 0 if it is skipped
+ */
+static inline int
+__mSample(MoxieState *state, MoxieState *global, MoxieSampler *sampler)
+{
+    unsigned long period = _M_STATE_LOAD(state->samplePeriod);
+    unsigned long epoch = __atomic_load_n(&state->sampleEpoch, __ATOMIC_RELAXED);
+    int random = _M_STATE_LOAD_RELAXED(state->sampleMode) == MOXIE_SAMPLE_RANDOM;
+    if (period <= 1)
+    {
+        __atomic_fetch_add(&global->sampleHits, 1, __ATOMIC_RELAXED);
+        return 1;
+    }
+    if (sampler->state != state || sampler->epoch != epoch)
+    {
+        sampler->state = state;
+        sampler->epoch = epoch;
+        sampler->countdown = 0;
+        sampler->drawn = 0;
+        /* The first call of MOXIE_SAMPLE_RANDOM is only sampled by chance. */
+        if (random && (sampler->drawn = __mSampleMisses(period)) != 0)
+        {
+            sampler->countdown = sampler->drawn - 1;
+            return 0;
+        }
+    }
+    __atomic_fetch_add(&global->sampleHits, 1, __ATOMIC_RELAXED);
+    if (sampler->drawn != sampler->countdown)
+    {
+        __atomic_fetch_add(&global->sampleSkips, sampler->drawn - sampler->countdown, __ATOMIC_RELAXED);
+    }
+    sampler->drawn = random ? __mSampleMisses(period) : (period - 1);
+    sampler->countdown = sampler->drawn;
+    return 1;
+}
+
+/**
+ * @brief Returns the i-th value of the splitmix64 sequence of the specified
+ * seed.
+ */
+static inline unsigned long long
+__mInjectDraw(unsigned long long seed, unsigned long long i)
+{
+    unsigned long long z = seed + (i + 1) * 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Returns whether the specified draw falls below the specified
+ * probability.
+ */
+static inline int
+__mInjectChance(unsigned long long draw, double probability)
+{
+    return (double)(draw >> 11) * (1.0 / 9007199254740992.0) < probability;
+}
+
+/**
+ * @brief Waits for the specified number of nanoseconds.
+ */
+static inline void
+__mInjectWait(MoxieWait wait, unsigned long ns)
+{
+#ifdef CLOCK_MONOTONIC
+    struct timespec now;
+    struct timespec end;
+    ++__mThreadInternal;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    end.tv_sec += (time_t)(ns / 1000000000ul);
+    end.tv_nsec += (long)(ns % 1000000000ul);
+    if (end.tv_nsec >= 1000000000l)
+    {
+        end.tv_sec += 1;
+        end.tv_nsec -= 1000000000l;
+    }
+    if (wait == MOXIE_WAIT_SLEEP)
+    {
+        struct timespec duration;
+        duration.tv_sec = (time_t)(ns / 1000000000ul);
+        duration.tv_nsec = (long)(ns % 1000000000ul);
+        while (nanosleep(&duration, &duration) != 0)
+        {
+        }
+        --__mThreadInternal;
+        return;
+    }
+    do
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    } while (now.tv_sec < end.tv_sec || (now.tv_sec == end.tv_sec && now.tv_nsec < end.tv_nsec));
+    --__mThreadInternal;
+#else
+    clock_t end;
+    (void)wait;
+    ++__mThreadInternal;
+    end = clock() + (clock_t)((double)ns * (CLOCKS_PER_SEC / 1e9));
+    while (clock() < end)
+    {
+    }
+    --__mThreadInternal;
+#endif
+}
+
+/**
+ * @brief Injects the latency of the specified MoxieInjection into a call of
+ * the specified global MoxieState and decides whether the call is faulted.
+ *
+ * @return 1 if the call is faulted or 0 if it proceeds
+ */
+static inline int
+__mInject(const MoxieInjection *injection, MoxieState *global)
+{
+    unsigned long long i = __atomic_fetch_add(&global->injectCursor, 1, __ATOMIC_RELAXED);
+    unsigned long long draw = __mInjectDraw(injection->seed, 3 * i);
+    if (__mInjectChance(draw, injection->latencyProbability))
+    {
+        unsigned long ns = injection->latencyNs;
+        if (injection->jitterNs != 0)
+        {
+            ns += (unsigned long)(__mInjectDraw(injection->seed, 3 * i + 1) % injection->jitterNs);
+        }
+        __mInjectWait(injection->wait, ns);
+    }
+    return __mInjectChance(__mInjectDraw(injection->seed, 3 * i + 2), injection->faultProbability);
+}
+
+#define _M_HASH_SEED 14695981039346656037ull
+#define _M_HASH_PRIME 1099511628211ull
+
+/**
+ * @brief Mixes the specified bytes into the specified FNV-1a hash.
+ */
+static inline unsigned long long
+__mHash(unsigned long long hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    size_t i;
+    for (i = 0; bytes != NULL && i < size; ++i)
+    {
+        hash = (hash ^ bytes[i]) * _M_HASH_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief Mixes the specified string, including its terminator, into the
+ * specified FNV-1a hash.
+ */
+static inline unsigned long long
+__mHashString(unsigned long long hash, const char *string)
+{
+    return __mHash(hash, string, (string != NULL) ? strlen(string) + 1 : 0);
+}
+
+/**
+ * @brief Returns the timestamp in nanoseconds of the profiling clock.
+ */
+static inline unsigned long long
+__mProfileNow(void)
+{
+#if defined(CLOCK_MONOTONIC_RAW) || defined(CLOCK_MONOTONIC)
+    struct timespec now;
+    ++__mThreadInternal;
+#ifdef CLOCK_MONOTONIC_RAW
+    clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+    --__mThreadInternal;
+    return (unsigned long long)now.tv_sec * 1000000000ull + (unsigned long long)now.tv_nsec;
+#else
+    clock_t now;
+    ++__mThreadInternal;
+    now = clock();
+    --__mThreadInternal;
+    return (unsigned long long)((double)now * (1e9 / CLOCKS_PER_SEC));
+#endif
+}
+
+/**
+ * @brief Returns the MoxieHistogram bucket of the specified latency.
+ */
+static inline unsigned long
+__mHistogramBucket(unsigned long long ns)
+{
+    unsigned long exponent;
+    if (ns < (1ull << _M_HISTOGRAM_SUB_BITS))
+    {
+        return (unsigned long)ns;
+    }
+    exponent = 63ul - (unsigned long)__builtin_clzll(ns);
+    return ((exponent - _M_HISTOGRAM_SUB_BITS + 1) << _M_HISTOGRAM_SUB_BITS)
+        + (unsigned long)((ns >> (exponent - _M_HISTOGRAM_SUB_BITS)) & ((1ull << _M_HISTOGRAM_SUB_BITS) - 1));
+}
+
+/**
+ * @brief Returns the upper bound of the latencies of the specified
+ * MoxieHistogram bucket.
+ */
+static inline unsigned long
+__mHistogramBound(unsigned long bucket)
+{
+    unsigned long group = bucket >> _M_HISTOGRAM_SUB_BITS;
+    unsigned long sub = bucket & ((1ul << _M_HISTOGRAM_SUB_BITS) - 1);
+    if (group == 0)
+    {
+        return sub;
+    }
+    return (unsigned long)((((1ull << _M_HISTOGRAM_SUB_BITS) + sub + 1) << (group - 1)) - 1);
+}
+
+/**
+ * @brief Records the latency since the specified timestamp into the specified
+ * MoxieHistogram of an epoch of the global MoxieState.
+ */
+static inline void
+__mHistogramRecord(MoxieHistogram *histogram, unsigned long epoch, unsigned long long start)
+{
+    unsigned long long end = __mProfileNow();
+    if (__atomic_load_n(&histogram->epoch, __ATOMIC_RELAXED) != epoch)
+    {
+        memset(histogram->counts, 0, sizeof(histogram->counts));
+        __atomic_store_n(&histogram->epoch, epoch, __ATOMIC_RELEASE);
+    }
+    __atomic_fetch_add(&histogram->counts[__mHistogramBucket((end > start) ? (end - start) : 0)], 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Returns the number of latencies of the specified MoxieHistograms in
+ * the specified epoch.
+ */
+static inline unsigned long
+__mHistogramCount(const MoxieHistogram *histograms, unsigned long size, unsigned long epoch)
+{
+    unsigned long count = 0;
+    unsigned long i;
+    unsigned long bucket;
+    for (i = 0; i < size; ++i)
+    {
+        if (__atomic_load_n(&histograms[i].epoch, __ATOMIC_ACQUIRE) != epoch)
+        {
+            continue;
+        }
+        for (bucket = 0; bucket < _M_HISTOGRAM_BUCKETS; ++bucket)
+        {
+            count += __atomic_load_n(&histograms[i].counts[bucket], __ATOMIC_RELAXED);
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Returns the specified quantile of the latencies of the specified
+ * MoxieHistograms in the specified epoch.
+ */
+static inline unsigned long
+__mHistogramQuantile(const MoxieHistogram *histograms, unsigned long size, unsigned long epoch, double quantile)
+{
+    unsigned long count = __mHistogramCount(histograms, size, epoch);
+    unsigned long rank;
+    unsigned long seen = 0;
+    unsigned long i;
+    unsigned long bucket;
+    if (count == 0)
+    {
+        return 0;
+    }
+    rank = (quantile <= 0.0) ? 1 : (quantile >= 1.0) ? count : (unsigned long)(quantile * (double)count + 0.5);
+    rank = (rank == 0) ? 1 : rank;
+    for (bucket = 0; bucket < _M_HISTOGRAM_BUCKETS; ++bucket)
+    {
+        for (i = 0; i < size; ++i)
+        {
+            if (__atomic_load_n(&histograms[i].epoch, __ATOMIC_ACQUIRE) == epoch)
+            {
+                seen += __atomic_load_n(&histograms[i].counts[bucket], __ATOMIC_RELAXED);
+            }
+        }
+        if (seen >= rank)
+        {
+            return __mHistogramBound(bucket);
+        }
+    }
+    return __mHistogramBound(_M_HISTOGRAM_BUCKETS - 1);
+}
+
+#ifdef MOXIE_MEMOIZE_CAPACITY
+/**
+ * @brief The number of slots that are probed for an entry of a memo cache.
+ */
+#define _M_MEMO_PROBES 4
+
+/**
+ * @brief A MoxieMemoEntry heads an entry of the memo cache of a mocked
+ * function, which is followed by the cached return value.
+ *
+ * The entry is only valid while its epoch is one past the callEpoch of the
+ * MoxieState, and while its sequence is even and unchanged.
+ */
+typedef struct MoxieMemoEntry
+{
+    unsigned long sequence;
+    unsigned long epoch;
+    unsigned long long key;
+} MoxieMemoEntry;
+
+/**
+ * @brief Returns whether every argument described by the specified parameters
+ * is hashed into the key of a memoized call.
+ *
+ * The pointers of M_PARAM_IN_PTR and M_PARAM_*_TYPE_PTR are not hashed, nor
+ * are the arguments of M_PARAM_CUSTOM, and the pointees of the output
+ * parameters would not be restored by a hit.
+ */
+static inline int
+__mMemoHashed(const char *parameters)
+{
+    return !__mHasParameter(parameters, _M_KIND_PTR)
+        && !__mHasParameter(parameters, _M_KIND_OUT_PTR)
+        && !__mHasParameter(parameters, _M_KIND_IN_TYPE_PTR)
+        && !__mHasParameter(parameters, _M_KIND_OUT_TYPE_PTR)
+        && !__mHasParameter(parameters, _M_KIND_CUSTOM);
+}
+
+/**
+ * @brief Returns the MoxieMemoEntry of the specified probe of the specified
+ * key in the specified memo cache.
+ */
+static inline MoxieMemoEntry *
+__mMemoEntry(void *entries, size_t stride, unsigned long capacity, unsigned long long key, unsigned long probe)
+{
+    return (MoxieMemoEntry *)((char *)entries + (size_t)((key ^ (key >> 32)) % capacity + probe) % capacity * stride);
+}
+
+/**
+ * @brief Copies the cached return value of the specified key into the
+ * specified result, counting a hit or miss on the specified global MoxieState.
+ *
+ * @return 1 if the call was served from the memo cache, or 0 otherwise
+ */
+static inline int
+__mMemoLookup(MoxieState *global, void *entries, size_t stride, unsigned long capacity, size_t offset,
+    unsigned long epoch, unsigned long long key, void *result, size_t size)
+{
+    unsigned long probe;
+    for (probe = 0; probe < _M_MEMO_PROBES && probe < capacity; ++probe)
+    {
+        MoxieMemoEntry *entry = __mMemoEntry(entries, stride, capacity, key, probe);
+        unsigned long sequence = __atomic_load_n(&entry->sequence, __ATOMIC_ACQUIRE);
+        if (sequence & 1)
+        {
+            continue;
+        }
+        if (__atomic_load_n(&entry->epoch, __ATOMIC_RELAXED) != epoch)
+        {
+            break;
+        }
+        if (__atomic_load_n(&entry->key, __ATOMIC_RELAXED) != key)
+        {
+            continue;
+        }
+        if (size != 0)
+        {
+            memcpy(result, (char *)entry + offset, size);
+        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&entry->sequence, __ATOMIC_RELAXED) == sequence)
+        {
+            __atomic_fetch_add(&global->memoHits, 1, __ATOMIC_RELAXED);
+            return 1;
+        }
+    }
+    __atomic_fetch_add(&global->memoMisses, 1, __ATOMIC_RELAXED);
+    return 0;
+}
+
+/**
+ * @brief Caches the specified return value of the specified key into the
+ * first free probe of the memo cache, or into its home slot if every probe is
+ * taken; the value is dropped if a racing call is writing the slot.
+ */
+static inline void
+__mMemoInsert(void *entries, size_t stride, unsigned long capacity, size_t offset,
+    unsigned long epoch, unsigned long long key, const void *result, size_t size)
+{
+    MoxieMemoEntry *entry = __mMemoEntry(entries, stride, capacity, key, 0);
+    unsigned long sequence;
+    unsigned long probe;
+    for (probe = 0; probe < _M_MEMO_PROBES && probe < capacity; ++probe)
+    {
+        MoxieMemoEntry *candidate = __mMemoEntry(entries, stride, capacity, key, probe);
+        if (__atomic_load_n(&candidate->epoch, __ATOMIC_RELAXED) != epoch
+            || __atomic_load_n(&candidate->key, __ATOMIC_RELAXED) == key)
+        {
+            entry = candidate;
+            break;
+        }
+    }
+    sequence = __atomic_load_n(&entry->sequence, __ATOMIC_RELAXED);
+    if ((sequence & 1) || !__atomic_compare_exchange_n(&entry->sequence, &sequence, sequence + 1, 0,
+        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+        return;
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&entry->key, key, __ATOMIC_RELAXED);
+    if (size != 0)
+    {
+        memcpy((char *)entry + offset, result, size);
+    }
+    __atomic_store_n(&entry->epoch, epoch, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry->sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+#endif
+
+// Parameter Lists:
+// - Every parameter list is expanded once per mock into a parenthesized macro
+//   argument, e.g. (int x, int y), which is then pasted verbatim wherever the
+//   list recurs (e.g. `__wrap_##FUNC DECL` and `__real_##FUNC CALL`) instead of
+//   rescanning the M_PARAM_* list of every use; the expanded lists contain no
+//   macros such that forwarding them costs a single scan of their tokens.
+// - The return type is likewise spelled MoxieReturn_##FUNC and the return
+//   keyword is expanded once into RETURN.
+#define _M_DECLARE_MOCK(RET,FUNC,...) \
+_M_DECLARE_MOCK_EXPANDED(RET,FUNC, \
+    (_M_PARAMS_PROTOTYPE(FUNC,__VA_ARGS__)), \
+    (_M_PARAMS_MOCK_PROTOTYPE(FUNC,__VA_ARGS__)), \
+    __VA_ARGS__)
+
+#define _M_DECLARE_MOCK_EXPANDED(RET,FUNC,PROTO,MPROTO,...) \
+typedef struct MoxieArgs_##FUNC \
+{ \
+    unsigned long __sequence; \
+    _M_PARAMS_FIELDS(FUNC,__VA_ARGS__) \
+} MoxieArgs_##FUNC; \
+typedef _M_RETURN_TYPE(RET) MoxieReturn_##FUNC; \
+typedef void (*MoxieCallFunc_##FUNC)MPROTO; \
+typedef MoxieReturn_##FUNC (*MoxieStubFunc_##FUNC)MPROTO; \
+typedef MoxieReturn_##FUNC (*MoxieRealFunc_##FUNC)PROTO; \
+typedef int (*MoxieFilterFunc_##FUNC)PROTO; \
+extern void __mReset_##FUNC(void); \
+extern void __mEnable_##FUNC(void); \
+extern void __mSetScope_##FUNC(const char *); \
+extern void __mSetCallFunc_##FUNC(MoxieCallFunc_##FUNC); \
+extern void __mSetStubFunc_##FUNC(MoxieStubFunc_##FUNC); \
+extern void __mSetFilter_##FUNC(MoxieFilterFunc_##FUNC); \
+extern void __mSpy_##FUNC(void); \
+extern unsigned long __mCallCount_##FUNC(void); \
+extern unsigned long __mThreadCallCount_##FUNC(void); \
+extern void __mCapture_##FUNC(void); \
+extern const MoxieArgs_##FUNC *__mCaptured_##FUNC(unsigned long); \
+extern unsigned long __mCapturedCount_##FUNC(void); \
+extern void __mSetReturnSequence_##FUNC(const MoxieReturn_##FUNC *, unsigned long, MoxieRepeat); \
+extern void __mSetSampling_##FUNC(unsigned long, MoxieSampling); \
+extern unsigned long __mSampleHits_##FUNC(void); \
+extern unsigned long __mSampleSkips_##FUNC(void); \
+extern void __mSetInjection_##FUNC(const MoxieInjection *, const MoxieReturn_##FUNC *); \
+extern void __mProfile_##FUNC(void); \
+extern unsigned long __mProfileCount_##FUNC(void); \
+extern unsigned long __mProfileQuantile_##FUNC(double); \
+extern void __mTrace_##FUNC(void); \
+extern void __mRecord_##FUNC(void); \
+extern void __mReplay_##FUNC(MoxieReplay); \
+extern void __mMemoize_##FUNC(void); \
+extern unsigned long __mMemoHits_##FUNC(void); \
+extern unsigned long __mMemoMisses_##FUNC(void); \
+extern void __mDefer_##FUNC(void); \
+_M_DECLARE_MOCK_THREAD_LOCAL(FUNC) \
+_M_DECLARE_MOCK_NATIVE(RET,FUNC) \
+extern MoxieReturn_##FUNC __real_##FUNC PROTO; \
+extern MoxieReturn_##FUNC __wrap_##FUNC PROTO; \
+extern void __mCallFunc_##FUNC MPROTO; \
+extern MoxieReturn_##FUNC __mStubFunc_##FUNC MPROTO;
+
+#ifdef MOXIE_THREAD_LOCAL_STATE
+#define _M_DECLARE_MOCK_THREAD_LOCAL(FUNC) extern void __mPublish_##FUNC(void);
+#else
+#define _M_DECLARE_MOCK_THREAD_LOCAL(FUNC)
+#endif
+
+#ifdef MOXIE_NATIVE_BACKEND
+#define _M_DECLARE_MOCK_NATIVE(RET,FUNC) \
+typedef struct MoxieExpectation_##FUNC \
+{ \
+    MoxieArgs_##FUNC args; \
+    unsigned long withMask; \
+    unsigned long count; \
+    int hasReturn; \
+    _M_IF(_M_EQUAL(_M_RETURN_TYPE(RET),void))(/* N/A. */, MoxieReturn_##FUNC returnValue;) \
+} MoxieExpectation_##FUNC; \
+extern MoxieExpectation_##FUNC *__mExpect_##FUNC(unsigned long); \
+extern unsigned long __mVerify_##FUNC(void);
+#else
+#define _M_DECLARE_MOCK_NATIVE(RET,FUNC)
+#endif
+
+#define _M_IMPLEMENT_MOCK(RET,FUNC,...) _M_IMPLEMENT_MOCK_LAYOUT(_M_LAYOUT_MOCK,RET,FUNC,__VA_ARGS__)
+
+#define _M_IMPLEMENT_MOCK_LAYOUT(LAYOUT,RET,FUNC,...) \
+_M_IMPLEMENT_MOCK_EXPANDED(LAYOUT,RET,FUNC, \
+    _M_RETURN(RET), \
+    (_M_PARAMS_DECLARATION(FUNC,__VA_ARGS__)), \
+    (_M_PARAMS_CALL(FUNC,__VA_ARGS__)), \
+    (_M_PARAMS_MOCK_DECLARATION(FUNC,__VA_ARGS__)), \
+    (_M_PARAMS_MOCK_CALL(FUNC,__VA_ARGS__)), \
+    __VA_ARGS__)
+
+#define _M_IMPLEMENT_MOCK_EXPANDED(LAYOUT,RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+_M_IMPLEMENT_MOCK_PREFACE(LAYOUT,RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__) \
+_M_IMPLEMENT_MOCK_SPY(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__) \
+_M_IMPLEMENT_MOCK_CAPTURE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__) \
+_M_IMPLEMENT_MOCK_SAMPLE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__) \
+_M_IMPLEMENT_MOCK_INJECT(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__) \
+_M_IMPLEMENT_MOCK_REAL(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__) \
+_M_IMPLEMENT_MOCK_PROFILE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__) \
+_M_IMPLEMENT_MOCK_RECORD(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__) \
+_M_IMPLEMENT_MOCK_MEMOIZE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__) \
+_M_IMPLEMENT_MOCK_DEFER(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__) \
+_M_IMPLEMENT_MOCK_NATIVE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__) \
+_M_IMPLEMENT_MOCK_SLOW(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__) \
+_M_IMPLEMENT_MOCK_TRACE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__) \
+_M_IMPLEMENT_MOCK_WRAP(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__) \
+_M_IMPLEMENT_MOCK_INTERPOSE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__) \
+_M_IMPLEMENT_MOCK_CALL(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__) \
+_M_IMPLEMENT_MOCK_STUB(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__) \
+_M_IMPLEMENT_MOCK_REGISTRATION(LAYOUT,RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__) \
+_M_DYLD_INTERPOSE(FUNC)
+
+// Layouts:
+// - The generated code addresses the MoxieState and the MoxieRegistration of
+//   FUNC through the constant __mStateOf_##FUNC and __mRegistrationOf_##FUNC,
+//   which the compiler folds into direct addresses, such that M_IMPLEMENT_MOCK
+//   defines them as objects of their own and M_IMPLEMENT_MOCK_TABLE as
+//   elements of the arrays shared by its table.
+#define _M_STATE_INITIALIZER(FUNC) \
+{ \
+    .mockFlag = 0, \
+    .scope = "", \
+    .callFunc = &__mCallFunc_##FUNC, \
+    .stubFunc = &__mStubFunc_##FUNC, \
+}
+
+#define _M_LAYOUT_MOCK_STATE(FUNC) \
+static MoxieState __mState_##FUNC = _M_STATE_INITIALIZER(FUNC); \
+static MoxieState *const __mStateOf_##FUNC = &__mState_##FUNC; \
+static const MoxieRegistration __mRegistration_##FUNC; \
+static const MoxieRegistration *const __mRegistrationOf_##FUNC __attribute__((unused)) = &__mRegistration_##FUNC;
+
+#define _M_LAYOUT_MOCK_REGISTRATION(RET,FUNC,...) \
+static const MoxieRegistration __mRegistration_##FUNC \
+__attribute__((used,section(_M_REGISTRY_SECTION),aligned(sizeof(void *)))) = \
+_M_REGISTRATION_INITIALIZER(&__mState_##FUNC,RET,FUNC,__VA_ARGS__);
+
+#define _M_IMPLEMENT_MOCK_PREFACE(LAYOUT,RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+static _M_ARMED_STORAGE int __mArmed_##FUNC = 0; \
+LAYOUT##_STATE(FUNC) \
+static __thread MoxieCounter __mThreadCounter_##FUNC = { \
+    .epoch = 0, \
+    .count = 0, \
+}; \
+static __thread MoxieSampler __mSampler_##FUNC = { \
+    .state = NULL, \
+    .countdown = 0, \
+}; \
+_M_IMPLEMENT_MOCK_THREAD_LOCAL(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__) \
+void __mReset_##FUNC(void) \
+{ \
+    MoxieState *state = _M_STATE_TARGET(FUNC); \
+    _M_STATE_ARM(FUNC, state, 0); \
+    _M_STATE_RESET(state, &__mCallFunc_##FUNC, &__mStubFunc_##FUNC); \
+    _M_STATE_RESET_TARGET_COUNTERS(FUNC); \
+    _M_STATE_UNTARGET(FUNC); \
+} \
+void __mEnable_##FUNC(void) \
+{ \
+    MoxieState *state = _M_STATE_TARGET(FUNC); \
+    _M_STATE_ARM(FUNC, state, _M_STATE_LOAD_RELAXED(state->mockFlag) | _M_FLAG_MOCK); \
+} \
+void __mSetScope_##FUNC(const char *scope) \
+{ \
+    MoxieState *state = _M_STATE_TARGET(FUNC); \
+    Assert(_M_STATE_LOAD_RELAXED(state->mockFlag) & _M_FLAG_MOCK); \
+    _M_STATE_STORE(state->scope, (char *)scope); \
+} \
+void __mSetCallFunc_##FUNC(MoxieCallFunc_##FUNC callFunc) \
+{ \
+    MoxieState *state = _M_STATE_TARGET(FUNC); \
+    Assert(_M_STATE_LOAD_RELAXED(state->mockFlag) & _M_FLAG_MOCK); \
+    _M_STATE_STORE(state->callFunc, (void *)callFunc); \
+} \
+void __mSetStubFunc_##FUNC(MoxieStubFunc_##FUNC stubFunc) \
+{ \
+    MoxieState *state = _M_STATE_TARGET(FUNC); \
+    Assert(_M_STATE_LOAD_RELAXED(state->mockFlag) & _M_FLAG_MOCK); \
+    _M_STATE_STORE(state->stubFunc, (void *)stubFunc); \
+} \
+void __mSetFilter_##FUNC(MoxieFilterFunc_##FUNC filter) \
+{ \
+    MoxieState *state = _M_STATE_TARGET(FUNC); \
+    _M_STATE_STORE(state->filter, (void *)filter); \
+} \
+void __mSetReturnSequence_##FUNC(const MoxieReturn_##FUNC *values, unsigned long count, MoxieRepeat repeat) \
+{ \
+    MoxieState *state = _M_STATE_TARGET(FUNC); \
+    int mockFlag = _M_STATE_LOAD_RELAXED(state->mockFlag) & ~_M_FLAG_RETURN; \
+    _M_STATE_ARM(FUNC, state, mockFlag); \
+    _M_STATE_STORE(state->returnValues, (const void *)values); \
+    _M_STATE_STORE(state->returnCount, count); \
+    _M_STATE_STORE(state->returnCursor, 0); \
+    _M_STATE_STORE(state->returnRepeat, repeat); \
+    _M_STATE_ARM(FUNC, state, (count != 0) ? (mockFlag | _M_FLAG_RETURN) : mockFlag); \
+}
+
+// Spy:
+// - The calls are counted on the Slow Path of the global MoxieState such that
+//   the counts are shared by every thread regardless of the configuration.
+#define _M_IMPLEMENT_MOCK_SPY(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+void __mSpy_##FUNC(void) \
+{ \
+    MoxieState *state = _M_STATE_TARGET(FUNC); \
+    _M_STATE_ARM(FUNC, state, _M_STATE_LOAD_RELAXED(state->mockFlag) | _M_FLAG_SPY); \
+} \
+unsigned long __mCallCount_##FUNC(void) \
+{ \
+    return __atomic_load_n(&__mStateOf_##FUNC->callCount, __ATOMIC_RELAXED); \
+} \
+unsigned long __mThreadCallCount_##FUNC(void) \
+{ \
+    unsigned long epoch = __atomic_load_n(&__mStateOf_##FUNC->callEpoch, __ATOMIC_RELAXED); \
+    return (__mThreadCounter_##FUNC.epoch == epoch) ? __mThreadCounter_##FUNC.count : 0; \
+}
+
+#define _M_SPY_COUNT(FUNC) __mSpyCount(__mStateOf_##FUNC, &__mThreadCounter_##FUNC)
+
+// Sample:
+// - The hits and skips are counted on the global MoxieState, like the Spy,
+//   whereas the period and mode follow the configuration of the thread.
+// - The unsampled calls count down the MoxieSampler of the thread on the Fast
+//   Path (see _M_SAMPLE_SKIPPED), such that a skipped call costs neither the
+//   Slow Path nor a shared atomic; the skips are published by the next sampled
+//   call of the thread.
+#define _M_IMPLEMENT_MOCK_SAMPLE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+void __mSetSampling_##FUNC(unsigned long period, MoxieSampling mode) \
+{ \
+    MoxieState *state = _M_STATE_TARGET(FUNC); \
+    int mockFlag = _M_STATE_LOAD_RELAXED(state->mockFlag) & ~_M_FLAG_SAMPLE; \
+    _M_STATE_ARM(FUNC, state, mockFlag); \
+    _M_STATE_STORE(state->samplePeriod, period); \
+    _M_STATE_STORE(state->sampleMode, mode); \
+    __atomic_add_fetch(&state->sampleEpoch, 1, __ATOMIC_RELAXED); \
+    _M_STATE_ARM(FUNC, state, (period > 1) ? (mockFlag | _M_FLAG_SAMPLE) : mockFlag); \
+} \
+unsigned long __mSampleHits_##FUNC(void) \
+{ \
+    return __atomic_load_n(&__mStateOf_##FUNC->sampleHits, __ATOMIC_RELAXED); \
+} \
+unsigned long __mSampleSkips_##FUNC(void) \
+{ \
+    unsigned long skips = __atomic_load_n(&__mStateOf_##FUNC->sampleSkips, __ATOMIC_RELAXED); \
+    return skips + __mSamplePending(&__mSampler_##FUNC); \
+}
+
+#define _M_SAMPLE_SKIPPED(FUNC) \
+(_M_UNLIKELY(__mSampler_##FUNC.countdown != 0) && __mSampleSkip(&__mSampler_##FUNC, _M_STATE_ACTIVE(FUNC)))
+
+// Inject:
+// - The sequence numbers of the calls are drawn from the global MoxieState,
+//   whereas the MoxieInjection follows the configuration of the thread.
+#define _M_IMPLEMENT_MOCK_INJECT(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+void __mSetInjection_##FUNC(const MoxieInjection *injection, const MoxieReturn_##FUNC *faultValue) \
+{ \
+    MoxieState *state = _M_STATE_TARGET(FUNC); \
+    int mockFlag = _M_STATE_LOAD_RELAXED(state->mockFlag) & ~_M_FLAG_INJECT; \
+    _M_STATE_ARM(FUNC, state, mockFlag); \
+    _M_STATE_STORE(state->injection, injection); \
+    _M_STATE_STORE(state->faultValue, (const void *)faultValue); \
+    __atomic_store_n(&__mStateOf_##FUNC->injectCursor, 0, __ATOMIC_RELAXED); \
+    _M_STATE_ARM(FUNC, state, (injection != NULL) ? (mockFlag | _M_FLAG_INJECT) : mockFlag); \
+}
+
+// Profile:
+// - Every thread claims a MoxieHistogram upon its first profiled call.
+// - The histograms follow the callEpoch of the global MoxieState, like the
+//   counters of the Spy, such that a reset is a single increment.
+#ifdef MOXIE_PROFILE_SHARDS
+#define _M_IMPLEMENT_MOCK_PROFILE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+static MoxieHistogram __mHistograms_##FUNC[MOXIE_PROFILE_SHARDS]; \
+static unsigned long __mHistogramCursor_##FUNC = 0; \
+static __thread MoxieHistogram *__mThreadHistogram_##FUNC = NULL; \
+void __mProfile_##FUNC(void) \
+{ \
+    MoxieState *state = _M_STATE_TARGET(FUNC); \
+    _M_STATE_ARM(FUNC, state, _M_STATE_LOAD_RELAXED(state->mockFlag) | _M_FLAG_PROFILE); \
+} \
+unsigned long __mProfileCount_##FUNC(void) \
+{ \
+    unsigned long epoch = __atomic_load_n(&__mStateOf_##FUNC->callEpoch, __ATOMIC_RELAXED); \
+    return __mHistogramCount(__mHistograms_##FUNC, MOXIE_PROFILE_SHARDS, epoch); \
+} \
+unsigned long __mProfileQuantile_##FUNC(double quantile) \
+{ \
+    unsigned long epoch = __atomic_load_n(&__mStateOf_##FUNC->callEpoch, __ATOMIC_RELAXED); \
+    return __mHistogramQuantile(__mHistograms_##FUNC, MOXIE_PROFILE_SHARDS, epoch, quantile); \
+} \
+static MoxieReturn_##FUNC __mProfileReal_##FUNC DECL \
+{ \
+    unsigned long epoch = __atomic_load_n(&__mStateOf_##FUNC->callEpoch, __ATOMIC_RELAXED); \
+    MoxieHistogram *histogram = __mThreadHistogram_##FUNC; \
+    if (histogram == NULL) \
+    { \
+        unsigned long shard = __atomic_fetch_add(&__mHistogramCursor_##FUNC, 1, __ATOMIC_RELAXED); \
+        histogram = &__mHistograms_##FUNC[shard % (MOXIE_PROFILE_SHARDS)]; \
+        __mThreadHistogram_##FUNC = histogram; \
+    } \
+    unsigned long long start = __mProfileNow(); \
+    _M_IF(_M_EQUAL(_M_RETURN_TYPE(RET),void))( \
+    __real_##FUNC CALL; \
+    __mHistogramRecord(histogram, epoch, start);, \
+    MoxieReturn_##FUNC result = __real_##FUNC CALL; \
+    __mHistogramRecord(histogram, epoch, start); \
+    return result;) \
+}
+#define _M_REAL_CALL(FUNC,RETURN,CALL) \
+if (mockFlag & _M_FLAG_PROFILE) \
+{ \
+    RETURN __mProfileReal_##FUNC CALL; \
+} \
+else \
+{ \
+    RETURN __real_##FUNC CALL; \
+}
+#else
+#define _M_IMPLEMENT_MOCK_PROFILE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...)
+#define _M_REAL_CALL(FUNC,RETURN,CALL) RETURN __real_##FUNC CALL
+#endif
+
+// Record:
+// - __mRecordReal_##FUNC replays the call, or calls the realFunc and records
+//   it, through __mReplayCall and __mRecordCall, such that each mocked
+//   function only hashes its arguments and lists its MoxieOutputs.
+// - The replay cursor follows the global MoxieState, such that the calls of
+//   every thread consume the MoxieRecords of the function in recording order.
+#ifdef MOXIE_RECORD_REPLAY
+#define _M_IMPLEMENT_MOCK_RECORD(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+void __mRecord_##FUNC(void) \
+{ \
+    MoxieState *state = _M_STATE_TARGET(FUNC); \
+    _M_STATE_ARM(FUNC, state, _M_STATE_LOAD_RELAXED(state->mockFlag) | _M_FLAG_RECORD); \
+} \
+void __mReplay_##FUNC(MoxieReplay match) \
+{ \
+    MoxieState *state = _M_STATE_TARGET(FUNC); \
+    _M_STATE_STORE(state->replayMatch, match); \
+    _M_STATE_ARM(FUNC, state, _M_STATE_LOAD_RELAXED(state->mockFlag) | _M_FLAG_REPLAY); \
+} \
+static MoxieReturn_##FUNC __mRecordReal_##FUNC DECL \
+{ \
+    MoxieState *state = _M_STATE_ACTIVE(FUNC); \
+    int mockFlag = _M_STATE_LOAD(state->mockFlag); \
+    MoxieReplay match = _M_STATE_LOAD(state->replayMatch); \
+    unsigned long long arguments = _M_HASH_SEED; \
+    const MoxieOutput outputs[] = { { NULL, 0 }, _M_PARAMS_OUTPUT(FUNC,__VA_ARGS__) }; \
+    unsigned long count = sizeof(outputs) / sizeof(outputs[0]) - 1; \
+    _M_PARAMS_HASH(FUNC,__VA_ARGS__) \
+    _M_IF(_M_EQUAL(_M_RETURN_TYPE(RET),void))( \
+    if ((mockFlag & _M_FLAG_REPLAY) && __mReplayCall(_M_STR(FUNC), __mStateOf_##FUNC, match, arguments, &outputs[1], count, NULL, 0)) \
+    { \
+        return; \
+    } \
+    __real_##FUNC CALL; \
+    if (mockFlag & _M_FLAG_RECORD) \
+    { \
+        __mRecordCall(_M_STR(FUNC), arguments, NULL, 0, &outputs[1], count); \
+    }, \
+    MoxieReturn_##FUNC result; \
+    if ((mockFlag & _M_FLAG_REPLAY) && __mReplayCall(_M_STR(FUNC), __mStateOf_##FUNC, match, arguments, &outputs[1], count, &result, sizeof(result))) \
+    { \
+        return result; \
+    } \
+    result = __real_##FUNC CALL; \
+    if (mockFlag & _M_FLAG_RECORD) \
+    { \
+        __mRecordCall(_M_STR(FUNC), arguments, &result, sizeof(result), &outputs[1], count); \
+    } \
+    return result;) \
+}
+#define _M_RECORD_CALL(FUNC,RETURN,CALL) \
+if (mockFlag & (_M_FLAG_RECORD | _M_FLAG_REPLAY)) \
+{ \
+    RETURN __mRecordReal_##FUNC CALL; \
+} \
+else \
+{ \
+    _M_MEMO_CALL(FUNC,RETURN,CALL); \
+}
+#else
+#define _M_IMPLEMENT_MOCK_RECORD(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...)
+#define _M_RECORD_CALL(FUNC,RETURN,CALL) _M_MEMO_CALL(FUNC,RETURN,CALL)
+#endif
+
+// Memoize:
+// - Every entry of the cache is written under a seqlock, such that a racing
+//   lookup misses rather than returning a torn result.
+// - The entries follow the callEpoch of the global MoxieState, like the
+//   histograms of the Profile, such that a reset is a single increment.
+#ifdef MOXIE_MEMOIZE_CAPACITY
+#define _M_IMPLEMENT_MOCK_MEMOIZE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+typedef struct MoxieMemo_##FUNC \
+{ \
+    MoxieMemoEntry entry; \
+    _M_IF(_M_EQUAL(_M_RETURN_TYPE(RET),void))(/* N/A. */, MoxieReturn_##FUNC result;) \
+} MoxieMemo_##FUNC; \
+static MoxieMemo_##FUNC __mMemo_##FUNC[MOXIE_MEMOIZE_CAPACITY]; \
+void __mMemoize_##FUNC(void) \
+{ \
+    MoxieState *state; \
+    int hashed = __mMemoHashed(__mRegistrationOf_##FUNC->parameters); \
+    Assert(hashed); \
+    if (!hashed) \
+    { \
+        return; \
+    } \
+    state = _M_STATE_TARGET(FUNC); \
+    _M_STATE_ARM(FUNC, state, _M_STATE_LOAD_RELAXED(state->mockFlag) | _M_FLAG_MEMOIZE); \
+} \
+unsigned long __mMemoHits_##FUNC(void) \
+{ \
+    return __atomic_load_n(&__mStateOf_##FUNC->memoHits, __ATOMIC_RELAXED); \
+} \
+unsigned long __mMemoMisses_##FUNC(void) \
+{ \
+    return __atomic_load_n(&__mStateOf_##FUNC->memoMisses, __ATOMIC_RELAXED); \
+} \
+static MoxieReturn_##FUNC __mMemoReal_##FUNC DECL \
+{ \
+    unsigned long epoch = __atomic_load_n(&__mStateOf_##FUNC->callEpoch, __ATOMIC_RELAXED) + 1; \
+    unsigned long long arguments = _M_HASH_SEED; \
+    _M_PARAMS_HASH(FUNC,__VA_ARGS__) \
+    _M_IF(_M_EQUAL(_M_RETURN_TYPE(RET),void))( \
+    if (__mMemoLookup(__mStateOf_##FUNC, __mMemo_##FUNC, sizeof(MoxieMemo_##FUNC), MOXIE_MEMOIZE_CAPACITY, \
+        sizeof(MoxieMemoEntry), epoch, arguments, NULL, 0)) \
+    { \
+        return; \
+    } \
+    __real_##FUNC CALL; \
+    __mMemoInsert(__mMemo_##FUNC, sizeof(MoxieMemo_##FUNC), MOXIE_MEMOIZE_CAPACITY, \
+        sizeof(MoxieMemoEntry), epoch, arguments, NULL, 0);, \
+    MoxieReturn_##FUNC result; \
+    if (__mMemoLookup(__mStateOf_##FUNC, __mMemo_##FUNC, sizeof(MoxieMemo_##FUNC), MOXIE_MEMOIZE_CAPACITY, \
+        offsetof(MoxieMemo_##FUNC, result), epoch, arguments, &result, sizeof(result))) \
+    { \
+        return result; \
+    } \
+    result = __real_##FUNC CALL; \
+    __mMemoInsert(__mMemo_##FUNC, sizeof(MoxieMemo_##FUNC), MOXIE_MEMOIZE_CAPACITY, \
+        offsetof(MoxieMemo_##FUNC, result), epoch, arguments, &result, sizeof(result)); \
+    return result;) \
+}
+#define _M_MEMO_CALL(FUNC,RETURN,CALL) \
+if (mockFlag & _M_FLAG_MEMOIZE) \
+{ \
+    RETURN __mMemoReal_##FUNC CALL; \
+} \
+else \
+{ \
+    _M_REAL_CALL(FUNC,RETURN,CALL); \
+}
+#else
+#define _M_IMPLEMENT_MOCK_MEMOIZE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...)
+#define _M_MEMO_CALL(FUNC,RETURN,CALL) _M_REAL_CALL(FUNC,RETURN,CALL)
+#endif
+
+// Capture:
+// - Every captured call claims the next slot of the ring buffer with a relaxed
+//   atomic increment, such that concurrent calls never share a slot until the
+//   ring buffer wraps around.
+// - The __sequence of a slot identifies the call that last wrote it.
+#ifdef MOXIE_CAPTURE_CAPACITY
+#define _M_IMPLEMENT_MOCK_CAPTURE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+static MoxieArgs_##FUNC __mCaptureBuffer_##FUNC[MOXIE_CAPTURE_CAPACITY]; \
+void __mCapture_##FUNC(void) \
+{ \
+    MoxieState *state = _M_STATE_TARGET(FUNC); \
+    _M_STATE_ARM(FUNC, state, _M_STATE_LOAD_RELAXED(state->mockFlag) | _M_FLAG_CAPTURE); \
+} \
+unsigned long __mCapturedCount_##FUNC(void) \
+{ \
+    return __atomic_load_n(&__mStateOf_##FUNC->captureCount, __ATOMIC_ACQUIRE); \
+} \
+const MoxieArgs_##FUNC *__mCaptured_##FUNC(unsigned long index) \
+{ \
+    unsigned long count = __atomic_load_n(&__mStateOf_##FUNC->captureCount, __ATOMIC_ACQUIRE); \
+    if (index >= count || index >= (unsigned long)(MOXIE_CAPTURE_CAPACITY)) \
+    { \
+        return NULL; \
+    } \
+    return &__mCaptureBuffer_##FUNC[(count - 1 - index) % (MOXIE_CAPTURE_CAPACITY)]; \
+}
+#define _M_CAPTURE_ARGS(FUNC,...) \
+do \
+{ \
+    unsigned long __sequence = __atomic_fetch_add(&__mStateOf_##FUNC->captureCount, 1, __ATOMIC_RELAXED); \
+    MoxieArgs_##FUNC *__args = &__mCaptureBuffer_##FUNC[__sequence % (MOXIE_CAPTURE_CAPACITY)]; \
+    __args->__sequence = __sequence; \
+    _M_PARAMS_CAPTURE(FUNC,__VA_ARGS__) \
+} while (0)
+#else
+#define _M_IMPLEMENT_MOCK_CAPTURE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...)
+#define _M_CAPTURE_ARGS(FUNC,...) ((void)0)
+#endif
+
+// Armed:
+// - __mArmed_##FUNC counts the global and thread-local MoxieStates that are
+//   enabled such that the Fast Path remains a single load and branch.
+// - The __mArmed_##FUNC of every mocked function are emitted into the
+//   "moxie_armed" linker section (or the "__DATA,__moxie_armed" section on
+//   macOS), such that the Fast Paths of every mocked function share a densely
+//   packed array, which is only written by the API Functions.
+// - _M_ARM adjusts __mArmed_##FUNC by the mockFlag that it replaced rather than
+//   by a prior load, such that racing API Functions never leave an enabled
+//   MoxieState unarmed.
+#ifdef __darwin__
+#define _M_ARMED_SECTION "__DATA,__moxie_armed"
+#else
+#define _M_ARMED_SECTION "moxie_armed"
+#endif
+#define _M_ARMED_STORAGE __attribute__((section(_M_ARMED_SECTION)))
+#define _M_STATE_ARMED(FUNC) __mArmed_##FUNC
+#define _M_STATE_ARM(FUNC,STATE,FLAG) _M_ARM(&__mArmed_##FUNC,STATE,FLAG)
+#define _M_ARM(ARMED,STATE,FLAG) \
+do \
+{ \
+    int __nextFlag = (FLAG); \
+    int __prevFlag = _M_STATE_EXCHANGE((STATE)->mockFlag, __nextFlag); \
+    __atomic_add_fetch((ARMED), (__nextFlag != 0) - (__prevFlag != 0), __ATOMIC_RELEASE); \
+} while (0)
+
+// Thread-Local State:
+// - The MoxieState of the calling thread is only consulted once the thread has
+//   called an API Function; otherwise, the global MoxieState is consulted.
+#ifdef MOXIE_THREAD_LOCAL_STATE
+#define _M_IMPLEMENT_MOCK_THREAD_LOCAL(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+static __thread MoxieState __mLocalState_##FUNC = { \
+    .mockFlag = 0, \
+    .scope = "", \
+    .callFunc = &__mCallFunc_##FUNC, \
+    .stubFunc = &__mStubFunc_##FUNC, \
+}; \
+static __thread int __mLocalFlag_##FUNC = 0; \
+void __mPublish_##FUNC(void) \
+{ \
+    MoxieState *state = &__mLocalState_##FUNC; \
+    _M_STATE_STORE(__mStateOf_##FUNC->scope, state->scope); \
+    _M_STATE_STORE(__mStateOf_##FUNC->callFunc, state->callFunc); \
+    _M_STATE_STORE(__mStateOf_##FUNC->stubFunc, state->stubFunc); \
+    _M_STATE_STORE(__mStateOf_##FUNC->samplePeriod, state->samplePeriod); \
+    _M_STATE_STORE(__mStateOf_##FUNC->sampleMode, state->sampleMode); \
+    __atomic_add_fetch(&__mStateOf_##FUNC->sampleEpoch, 1, __ATOMIC_RELAXED); \
+    _M_STATE_STORE(__mStateOf_##FUNC->injection, state->injection); \
+    _M_STATE_STORE(__mStateOf_##FUNC->faultValue, state->faultValue); \
+    _M_STATE_STORE(__mStateOf_##FUNC->replayMatch, state->replayMatch); \
+    _M_STATE_STORE(__mStateOf_##FUNC->filter, state->filter); \
+    _M_STATE_ARM(FUNC, __mStateOf_##FUNC, state->mockFlag); \
+}
+// - A thread that targets its MoxieState is reset upon its exit, such that its
+//   MoxieStates do not arm the Fast Path of the other threads for good.
+#define _M_STATE_TARGET(FUNC) (__mLocalFlag_##FUNC = 1, __mThreadExitWatch(), &__mLocalState_##FUNC)
+#define _M_STATE_UNTARGET(FUNC) (__mLocalFlag_##FUNC = 0)
+#define _M_STATE_ACTIVE(FUNC) (__mLocalFlag_##FUNC ? &__mLocalState_##FUNC : __mStateOf_##FUNC)
+// - The counters and cursors of the global MoxieState are shared by every
+//   thread, such that Moxie_reset(FUNC)() only resets the count of the calling
+//   thread and leaves the global ones to Moxie_resetAll().
+#define _M_STATE_RESET_TARGET_COUNTERS(FUNC) (__mThreadCounter_##FUNC.count = 0)
+#else
+#define _M_IMPLEMENT_MOCK_THREAD_LOCAL(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...)
+#define _M_STATE_TARGET(FUNC) (__mStateOf_##FUNC)
+#define _M_STATE_UNTARGET(FUNC) ((void)0)
+#define _M_STATE_ACTIVE(FUNC) (__mStateOf_##FUNC)
+#define _M_STATE_RESET_TARGET_COUNTERS(FUNC) _M_STATE_RESET_COUNTERS(__mStateOf_##FUNC)
+#endif
+
+#ifdef __darwin__
+#define _M_IMPLEMENT_MOCK_REAL(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+MoxieReturn_##FUNC __real_##FUNC DECL \
+{ \
+    RETURN FUNC CALL; \
+}
+#elif defined(_M_RTLD_NEXT)
+#define _M_IMPLEMENT_MOCK_REAL(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+MoxieReturn_##FUNC __real_##FUNC DECL \
+{ \
+    MoxieRealFunc_##FUNC realFunc = (MoxieRealFunc_##FUNC)__atomic_load_n(&__mStateOf_##FUNC->realFunc, __ATOMIC_RELAXED); \
+    if (_M_UNLIKELY(realFunc == NULL)) \
+    { \
+        realFunc = (MoxieRealFunc_##FUNC)__mResolveReal(__mStateOf_##FUNC, _M_STR(FUNC)); \
+    } \
+    RETURN (*realFunc) CALL; \
+}
+#else
+#define _M_IMPLEMENT_MOCK_REAL(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...)
+#endif
+
+// Trace:
+// - __mTracePath_##FUNC times the Slow Path of the call, such that tracing
+//   adds nothing to the Fast Path; the filtered calls are not traced.
+// - The event is appended by __mTraceRecord, which only needs the constant
+//   MoxieRegistration of the function.
+#ifdef MOXIE_TRACE_CAPACITY
+#define _M_IMPLEMENT_MOCK_TRACE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+void __mTrace_##FUNC(void) \
+{ \
+    MoxieState *state = _M_STATE_TARGET(FUNC); \
+    _M_STATE_ARM(FUNC, state, _M_STATE_LOAD_RELAXED(state->mockFlag) | _M_FLAG_TRACE); \
+} \
+static _M_COLD MoxieReturn_##FUNC __mTracePath_##FUNC DECL \
+{ \
+    MoxieState *state = _M_STATE_ACTIVE(FUNC); \
+    if ((_M_STATE_LOAD(state->mockFlag) & _M_FLAG_TRACE) && !_M_FILTERED(FUNC,state,CALL)) \
+    { \
+        unsigned long long start = __mProfileNow(); \
+        _M_IF(_M_EQUAL(_M_RETURN_TYPE(RET),void))( \
+        __mSlowPath_##FUNC CALL; \
+        __mTraceRecord(__mRegistrationOf_##FUNC, start); \
+        return;, \
+        MoxieReturn_##FUNC result = __mSlowPath_##FUNC CALL; \
+        __mTraceRecord(__mRegistrationOf_##FUNC, start); \
+        return result;) \
+    } \
+    RETURN __mSlowPath_##FUNC CALL; \
+}
+#define _M_SLOW_PATH(FUNC) __mTracePath_##FUNC
+#else
+#define _M_IMPLEMENT_MOCK_TRACE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...)
+#define _M_SLOW_PATH(FUNC) __mSlowPath_##FUNC
+#endif
+
+#ifdef MOXIE_CALLER_FILTER
+#define _M_CALLER_SKIPPED() (!__mCallerAllowed(__builtin_return_address(0)))
+#else
+#define _M_CALLER_SKIPPED() 0
+#endif
+
+// Wrap:
+// - __wrap_##FUNC is limited to the Fast Path such that it remains small enough
+//   to be inlined and to keep the realFunc call hot in the I-cache; both of its
+//   branches compile to tail calls.
+// - __mSlowPath_##FUNC is emitted out-of-line into the cold text section.
+// - _M_SLOW_PATH(FUNC) enters the Slow Path through __mTracePath_##FUNC if
+//   MOXIE_TRACE_CAPACITY is defined.
+// - _M_CALLER_SKIPPED() sends the armed calls of the modules that were not
+//   named by Moxie_setCallerModules() to the Fast Path if MOXIE_CALLER_FILTER
+//   is defined; it is only evaluated once the mockFlag is set.
+// - The calls made by Moxie itself (see __mThreadInternal) are sent to the
+//   Fast Path once the mockFlag is set.
+// - _M_SAMPLE_SKIPPED(FUNC) sends the unsampled calls of Moxie_setSampling(FUNC)
+//   to the Fast Path while the countdown of the calling thread is set.
+#define _M_IMPLEMENT_MOCK_WRAP(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+_M_WRAP_LINKAGE MoxieReturn_##FUNC _M_WRAP_SYMBOL(FUNC) DECL \
+{ \
+    int mockFlag = _M_STATE_LOAD_RELAXED(_M_STATE_ARMED(FUNC)); \
+    /* Fast Path: */ \
+    if (_M_LIKELY(!mockFlag) || _M_CALLER_SKIPPED() || __mThreadInternal || _M_SAMPLE_SKIPPED(FUNC)) \
+    { \
+        RETURN __real_##FUNC CALL; \
+    } \
+    /* Slow Path: */ \
+    else \
+    { \
+        RETURN _M_SLOW_PATH(FUNC) CALL; \
+    } \
+} \
+_M_IMPLEMENT_MOCK_DISPATCH(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,__VA_ARGS__)
+
+#if defined(_M_SHARED_SLOW_PATH) || defined(_M_DEFERRED)
+// Packed Arguments:
+// - The arguments of a call are packed by _M_PARAMS_PACK into MoxieValues as
+//   described by the parameters of the MoxieRegistration of the function,
+//   such that the shared routines can record them without any typed code.
+#define _M_SHARED __attribute__((weak,visibility("hidden"),noinline,cold))
+
+typedef union MoxieValue
+{
+    int i;
+    unsigned int u;
+    long l;
+    unsigned long ul;
+    double d;
+    const char *s;
+    const void *p;
+} MoxieValue;
+
+/**
+ * @brief Records the specified packed arguments into the specified
+ * MockActualCall_c as described by the specified parameters.
+ */
+_M_SHARED void
+__mWithParameters(const char *parameter, MockActualCall_c *actualCall, const MoxieValue *args)
+{
+    for (; *parameter != _M_KIND_NONE; ++args)
+    {
+        int kind = *parameter++;
+        const char *type = parameter;
+        if (kind == _M_KIND_IN_TYPE_PTR || kind == _M_KIND_OUT_TYPE_PTR)
+        {
+            parameter += strlen(parameter) + 1;
+        }
+        const char *name = parameter;
+        parameter += strlen(parameter) + 1;
+        switch (kind)
+        {
+        case _M_KIND_BOOL:
+            actualCall->withBoolParameters(name, args->i);
+            break;
+        case _M_KIND_INT:
+            actualCall->withIntParameters(name, args->i);
+            break;
+        case _M_KIND_UINT:
+            actualCall->withUnsignedIntParameters(name, args->u);
+            break;
+        case _M_KIND_LONG:
+            actualCall->withLongIntParameters(name, args->l);
+            break;
+        case _M_KIND_ULONG:
+            actualCall->withUnsignedLongIntParameters(name, args->ul);
+            break;
+        case _M_KIND_DOUBLE:
+            actualCall->withDoubleParameters(name, args->d);
+            break;
+        case _M_KIND_CHAR_PTR:
+            actualCall->withStringParameters(name, args->s);
+            break;
+        case _M_KIND_PTR:
+            actualCall->withPointerParameters(name, (void *)args->p);
+            break;
+        case _M_KIND_OUT_PTR:
+            actualCall->withOutputParameter(name, (void *)args->p);
+            break;
+        case _M_KIND_IN_TYPE_PTR:
+            actualCall->withParameterOfType(type, name, args->p);
+            break;
+        case _M_KIND_OUT_TYPE_PTR:
+            actualCall->withOutputParameterOfType(type, name, (void *)args->p);
+            break;
+        case _M_KIND_BUFFER:
+            actualCall->withMemoryBufferParameter(name, (const unsigned char *)args[0].p, (size_t)args[1].ul);
+            ++args;
+            break;
+        default:
+            break;
+        }
+    }
+}
+#endif
+
+#ifdef _M_DEFERRED
+/*
+ * Deferred Verification:
+ * A deferred call is appended to the log as a header of _M_DEFER_HEADER
+ * MoxieValues (its MoxieRegistration, scope, size, and whether its parameters
+ * are recorded), followed by its packed arguments and the bytes of its
+ * strings and buffers, which are copied such that the caller may reuse them
+ * before the log is flushed into CppUMock.
+ *
+ * The log is weak and hidden such that every translation unit of an
+ * executable or shared object appends to the same log, in call order.
+ */
+
+#define _M_DEFER_HEADER 4
+
+MoxieValue __mDeferLog[MOXIE_DEFER_CAPACITY] __attribute__((weak,visibility("hidden")));
+unsigned long __mDeferSize __attribute__((weak,visibility("hidden"))) = 0;
+
+/**
+ * @brief Replays the deferred calls of every mocked function into CppUMock
+ * through actualCall(), in call order, and empties the log.
+ *
+ * A mismatched call fails the test upon the replay with the same report as
+ * a call that is not deferred.
+ *
+ * @example Moxie_flushDeferred();
+ */
+static inline void
+Moxie_flushDeferred(void)
+{
+    unsigned long size = __mDeferSize;
+    unsigned long cursor = 0;
+    __mDeferSize = 0;
+    while (cursor < size)
+    {
+        const MoxieValue *entry = &__mDeferLog[cursor];
+        const MoxieRegistration *registration = (const MoxieRegistration *)entry[0].p;
+        const char *scope = entry[1].s;
+        MockSupport_c *mockSupport = (scope[0] == '\0') ? mock_c() : mock_scope_c(scope);
+        MockActualCall_c *actualCall = mockSupport->actualCall(registration->name);
+        if (entry[3].i)
+        {
+            __mWithParameters(registration->parameters, actualCall, &entry[_M_DEFER_HEADER]);
+        }
+        cursor += entry[2].ul;
+    }
+}
+
+/**
+ * @brief Replays the deferred calls through Moxie_flushDeferred() and checks
+ * the expectations of CppUMock.
+ *
+ * @example Moxie_checkExpectations();
+ */
+static inline void
+Moxie_checkExpectations(void)
+{
+    Moxie_flushDeferred();
+    mock_c()->checkExpectations();
+}
+
+/**
+ * @brief Appends a call of the specified mocked function, of which the
+ * arguments are packed as described by its parameters, to the log.
+ *
+ * @return 1 if the call is appended, 0 if the log is full, or -1 if the call
+ * cannot be deferred
+ */
+static inline int
+__mDeferAppend(const MoxieRegistration *registration, const char *scope, const MoxieValue *args, int described)
+{
+    unsigned long start = __mDeferSize;
+    unsigned long count = 0;
+    unsigned long cursor;
+    const char *parameter;
+    if (described)
+    {
+        for (parameter = registration->parameters; *parameter != _M_KIND_NONE; )
+        {
+            int kind = *parameter++;
+            if (kind == _M_KIND_OUT_PTR || kind == _M_KIND_IN_TYPE_PTR || kind == _M_KIND_OUT_TYPE_PTR || kind == _M_KIND_CUSTOM)
+            {
+                return -1;
+            }
+            parameter += strlen(parameter) + 1;
+            count += (kind == _M_KIND_BUFFER) ? 2 : 1;
+        }
+    }
+    cursor = start + _M_DEFER_HEADER + count;
+    if (cursor > MOXIE_DEFER_CAPACITY)
+    {
+        return 0;
+    }
+    memcpy(&__mDeferLog[start + _M_DEFER_HEADER], args, count * sizeof(MoxieValue));
+    if (described)
+    {
+        MoxieValue *arg = &__mDeferLog[start + _M_DEFER_HEADER];
+        for (parameter = registration->parameters; *parameter != _M_KIND_NONE; ++arg)
+        {
+            int kind = *parameter++;
+            size_t length;
+            unsigned long slots;
+            parameter += strlen(parameter) + 1;
+            if (kind == _M_KIND_CHAR_PTR && arg->p != NULL)
+            {
+                length = strlen(arg->s) + 1;
+            }
+            else if (kind == _M_KIND_BUFFER && arg->p != NULL)
+            {
+                length = (size_t)arg[1].ul;
+            }
+            else
+            {
+                arg += (kind == _M_KIND_BUFFER) ? 1 : 0;
+                continue;
+            }
+            slots = (length + sizeof(MoxieValue) - 1) / sizeof(MoxieValue);
+            if (cursor + slots > MOXIE_DEFER_CAPACITY)
+            {
+                return 0;
+            }
+            memcpy(&__mDeferLog[cursor], arg->p, length);
+            arg->p = &__mDeferLog[cursor];
+            cursor += slots;
+            arg += (kind == _M_KIND_BUFFER) ? 1 : 0;
+        }
+    }
+    __mDeferLog[start].p = registration;
+    __mDeferLog[start + 1].s = scope;
+    __mDeferLog[start + 2].ul = cursor - start;
+    __mDeferLog[start + 3].i = described;
+    __mDeferSize = cursor;
+    return 1;
+}
+
+/**
+ * @brief Defers a call of the specified mocked function, of which the
+ * arguments are packed as described by its parameters, flushing the log
+ * once it is full.
+ *
+ * The calls with a custom callFunc or with an M_PARAM_OUT_PTR,
+ * M_PARAM_OUT_TYPE_PTR, M_PARAM_OUT_BUFFER, M_PARAM_IN_TYPE_PTR, or
+ * M_PARAM_CUSTOM are not deferred; the log is flushed instead, such that the
+ * caller processes them through CppUMock in call order.
+ *
+ * @return whether the call is deferred
+ */
+_M_SHARED int
+__mDeferCall(const MoxieRegistration *registration, MoxieState *state, const MoxieValue *args)
+{
+    void *callFunc = _M_STATE_LOAD(state->callFunc);
+    char *scope = _M_STATE_LOAD(state->scope);
+    int appended = -1;
+    if (callFunc == NULL || callFunc == registration->callFunc)
+    {
+        appended = __mDeferAppend(registration, scope, args, callFunc != NULL);
+        if (appended == 0)
+        {
+            Moxie_flushDeferred();
+            appended = __mDeferAppend(registration, scope, args, callFunc != NULL);
+        }
+    }
+    if (appended != 1)
+    {
+        Moxie_flushDeferred();
+        return 0;
+    }
+    return 1;
+}
+#endif
+
+// Defer:
+// - _M_DEFER_CALL appends a mocked call to the log instead of processing it
+//   through CppUMock, and returns from the stubFunc (with NULL MockSupport_c
+//   and MockActualCall_c) if it is not the default stubFunc, which would read
+//   the return value of the actualCall; otherwise, from the realFunc.
+// - The next value of a return sequence is only returned once the call is
+//   appended to the log, or processed at once through CppUMock if it cannot
+//   be deferred (_M_DEFER_RETURN), such that CppUMock sees every call.
+// - _M_FLUSH_DEFERRED replays the log before every call that is processed
+//   through CppUMock at once, deferred or not, such that CppUMock sees the
+//   calls in call order.
+#ifdef _M_DEFERRED
+#define _M_IMPLEMENT_MOCK_DEFER(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+void __mDefer_##FUNC(void) \
+{ \
+    MoxieState *state = _M_STATE_TARGET(FUNC); \
+    _M_STATE_ARM(FUNC, state, _M_STATE_LOAD_RELAXED(state->mockFlag) | _M_FLAG_MOCK | _M_FLAG_DEFER); \
+}
+#define _M_DEFER_CALL(RET,FUNC,RETURN,CALL,MCALL,...) \
+if (mockFlag & _M_FLAG_DEFER) \
+{ \
+    const MoxieValue deferArgs[] = { { .l = 0 }, _M_PARAMS_PACK(FUNC,__VA_ARGS__) }; \
+    if (__mDeferCall(__mRegistrationOf_##FUNC, state, &deferArgs[1])) \
+    { \
+        unsigned long deferIndex; \
+        if ((mockFlag & _M_FLAG_RETURN) && __mNextReturn(state, &deferIndex)) \
+        { \
+            _M_RETURN_SEQUENCE(RET,FUNC,_M_STATE_LOAD(state->returnValues),deferIndex); \
+        } \
+        MoxieStubFunc_##FUNC stubFunc = (MoxieStubFunc_##FUNC)_M_STATE_LOAD(state->stubFunc); \
+        if (stubFunc != NULL && stubFunc != &__mStubFunc_##FUNC) \
+        { \
+            MockSupport_c *mockSupport = NULL; \
+            MockActualCall_c *actualCall = NULL; \
+            _M_IF(_M_EQUAL(_M_RETURN_TYPE(RET),void))((*stubFunc) MCALL; return;, return (*stubFunc) MCALL;) \
+        } \
+        _M_RECORD_CALL(FUNC,RETURN,CALL); \
+        _M_IF(_M_EQUAL(_M_RETURN_TYPE(RET),void))(return;, /* N/A. */) \
+    } \
+}
+#define _M_DEFER_RETURN(RET,FUNC) \
+unsigned long deferIndex; \
+if ((mockFlag & _M_FLAG_DEFER) && (mockFlag & _M_FLAG_RETURN) && __mNextReturn(state, &deferIndex)) \
+{ \
+    _M_RETURN_SEQUENCE(RET,FUNC,_M_STATE_LOAD(state->returnValues),deferIndex); \
+}
+#define _M_FLUSH_DEFERRED() \
+if (__mDeferSize != 0) \
+{ \
+    Moxie_flushDeferred(); \
+}
+#else
+#define _M_IMPLEMENT_MOCK_DEFER(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...)
+#define _M_DEFER_CALL(RET,FUNC,RETURN,CALL,MCALL,...)
+#define _M_DEFER_RETURN(RET,FUNC)
+#define _M_FLUSH_DEFERRED()
+#endif
+
+#ifdef _M_SHARED_SLOW_PATH
+// Shared Slow Path:
+// - __mSlowPath_##FUNC only resolves the state, captures, and packs the
+//   arguments into MoxieValues on its stack; __mSlowPathEnter and
+//   __mSlowPathShared implement the rest for every mocked function, driven by
+//   the constant MoxieRegistration of the function.
+// - The shared routines are weak and hidden such that every translation unit
+//   may emit them while the linker only keeps one copy.
+// - The MoxieRegistration of the function serves as its descriptor, whose
+//   parameters are encoded by _M_PARAM_DESCRIPTOR_* into a single string
+//   literal, such that the descriptor only adds a pointer to the registry.
+// - The shared routines return an action to __mSlowPath_##FUNC, which only
+//   converts the results and invokes the typed callFunc, stubFunc, and
+//   realFunc of the function.
+#define _M_SLOW_REAL 0
+#define _M_SLOW_VALUE 1
+#define _M_SLOW_RESULT 2
+#define _M_SLOW_CALL 3
+#define _M_SLOW_STUB 4
+
+typedef struct MoxieSlowPath
+{
+    MockSupport_c *mockSupport;
+    MockActualCall_c *actualCall;
+    const void *values;
+    unsigned long index;
+    MoxieValue result;
+} MoxieSlowPath;
+
+/**
+ * @brief Samples and counts a call of the specified mocked function.
+ *
+ * @return the mockFlag of the specified MoxieState, or 0 if the call is
+ * skipped
+ */
+_M_SHARED int
+__mSlowPathEnter(const MoxieRegistration *registration, MoxieState *state, MoxieCounter *counter, MoxieSampler *sampler)
+{
+    int mockFlag = _M_STATE_LOAD(state->mockFlag);
+    if ((mockFlag & _M_FLAG_SAMPLE) && !__mSample(state, registration->state, sampler))
+    {
+        return 0;
+    }
+    if (mockFlag & _M_FLAG_SPY)
+    {
+        __mSpyCount(registration->state, counter);
+    }
+    return mockFlag;
+}
+
+/**
+ * @brief Processes a sampled call of the specified mocked function, of which
+ * the arguments are packed as described by its parameters.
+ *
+ * @return the _M_SLOW_* action that remains for the mocked function
+ */
+_M_SHARED int
+__mSlowPathShared(const MoxieRegistration *registration, MoxieState *state, int mockFlag, const MoxieValue *args, MoxieSlowPath *slow)
+{
+    /* Inject Latency and Faults: */
+    if ((mockFlag & _M_FLAG_INJECT) && __mInject(_M_STATE_LOAD(state->injection), registration->state))
+    {
+        slow->values = _M_STATE_LOAD(state->faultValue);
+        slow->index = 0;
+        return _M_SLOW_VALUE;
+    }
+    /* Defer to Return Sequence: */
+    if ((mockFlag & _M_FLAG_RETURN) && !(mockFlag & _M_FLAG_DEFER) && __mNextReturn(state, &slow->index))
+    {
+        slow->values = _M_STATE_LOAD(state->returnValues);
+        return _M_SLOW_VALUE;
+    }
+    if (!(mockFlag & _M_FLAG_MOCK))
+    {
+        return _M_SLOW_REAL;
+    }
+#ifdef _M_DEFERRED
+    /* Defer Call: */
+    if ((mockFlag & _M_FLAG_DEFER) && __mDeferCall(registration, state, args))
+    {
+        if ((mockFlag & _M_FLAG_RETURN) && __mNextReturn(state, &slow->index))
+        {
+            slow->values = _M_STATE_LOAD(state->returnValues);
+            return _M_SLOW_VALUE;
+        }
+        void *stubFunc = _M_STATE_LOAD(state->stubFunc);
+        slow->mockSupport = NULL;
+        slow->actualCall = NULL;
+        return (stubFunc != NULL && stubFunc != registration->stubFunc) ? _M_SLOW_STUB : _M_SLOW_REAL;
+    }
+#endif
+    /* Process Call: */
+    _M_FLUSH_DEFERRED();
+    char *scope = _M_STATE_LOAD(state->scope);
+    MockSupport_c *mockSupport = (scope[0] == '\0') ? mock_c() : mock_scope_c(scope);
+    MockActualCall_c *actualCall = mockSupport->actualCall(registration->name);
+    slow->mockSupport = mockSupport;
+    slow->actualCall = actualCall;
+    slow->values = NULL;
+#ifdef _M_DEFERRED
+    /* Defer to Return Sequence: */
+    if ((mockFlag & _M_FLAG_DEFER) && (mockFlag & _M_FLAG_RETURN) && __mNextReturn(state, &slow->index))
+    {
+        slow->values = _M_STATE_LOAD(state->returnValues);
+    }
+#endif
+    /* Defer to callFunc: */
+    void *callFunc = _M_STATE_LOAD(state->callFunc);
+    if (callFunc != registration->callFunc || __mHasParameter(registration->parameters, _M_KIND_CUSTOM))
+    {
+        if (callFunc != NULL)
+        {
+            return _M_SLOW_CALL;
+        }
+    }
+    else
+    {
+        __mWithParameters(registration->parameters, actualCall, args);
+    }
+    if (slow->values != NULL)
+    {
+        return _M_SLOW_VALUE;
+    }
+    /* Defer to stubFunc: */
+    void *stubFunc = _M_STATE_LOAD(state->stubFunc);
+    if (stubFunc == NULL)
+    {
+        return _M_SLOW_REAL;
+    }
+    if (stubFunc != registration->stubFunc || registration->returnKind == _M_KIND_CUSTOM)
+    {
+        return _M_SLOW_STUB;
+    }
+    if (!actualCall->hasReturnValue())
+    {
+        return _M_SLOW_REAL;
+    }
+    switch (registration->returnKind)
+    {
+    case _M_KIND_BOOL:
+        slow->result.i = actualCall->boolReturnValue();
+        break;
+    case _M_KIND_INT:
+        slow->result.i = actualCall->intReturnValue();
+        break;
+    case _M_KIND_UINT:
+        slow->result.u = actualCall->unsignedIntReturnValue();
+        break;
+    case _M_KIND_LONG:
+        slow->result.l = actualCall->longIntReturnValue();
+        break;
+    case _M_KIND_ULONG:
+        slow->result.ul = actualCall->unsignedLongIntReturnValue();
+        break;
+    case _M_KIND_DOUBLE:
+        slow->result.d = actualCall->doubleReturnValue();
+        break;
+    case _M_KIND_CHAR_PTR:
+        slow->result.s = actualCall->stringReturnValue();
+        break;
+    case _M_KIND_PTR:
+        slow->result.p = actualCall->pointerReturnValue();
+        break;
+    default:
+        break;
+    }
+    return _M_SLOW_RESULT;
+}
+
+#define _M_IMPLEMENT_MOCK_SLOW(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+static _M_COLD MoxieReturn_##FUNC __mSlowPath_##FUNC DECL \
+{ \
+    /* Resolve State: */ \
+    MoxieState *state = _M_STATE_ACTIVE(FUNC); \
+    /* Skip Filtered Call: */ \
+    if (_M_FILTERED(FUNC,state,CALL)) \
+    { \
+        _M_IF(_M_EQUAL(_M_RETURN_TYPE(RET),void))(__real_##FUNC CALL; return;, return __real_##FUNC CALL;) \
+    } \
+    int mockFlag = __mSlowPathEnter(__mRegistrationOf_##FUNC, state, &__mThreadCounter_##FUNC, &__mSampler_##FUNC); \
+    if (mockFlag != 0) \
+    { \
+        /* Capture Arguments: */ \
+        if (mockFlag & _M_FLAG_CAPTURE) \
+        { \
+            _M_CAPTURE_ARGS(FUNC,__VA_ARGS__); \
+        } \
+        /* Pack Arguments: */ \
+        const MoxieValue args[] = { { .l = 0 }, _M_PARAMS_PACK(FUNC,__VA_ARGS__) }; \
+        MoxieSlowPath slow; \
+        int action = __mSlowPathShared(__mRegistrationOf_##FUNC, state, mockFlag, &args[1], &slow); \
+        if (action == _M_SLOW_VALUE) \
+        { \
+            _M_RETURN_SEQUENCE(RET,FUNC,slow.values,slow.index); \
+        } \
+        else if (action == _M_SLOW_RESULT) \
+        { \
+            _M_RETURN_SHARED(RET) \
+        } \
+        else if (action != _M_SLOW_REAL) \
+        { \
+            MockSupport_c *mockSupport = slow.mockSupport; \
+            MockActualCall_c *actualCall = slow.actualCall; \
+            /* Defer to callFunc: */ \
+            if (action == _M_SLOW_CALL) \
+            { \
+                MoxieCallFunc_##FUNC callFunc = (MoxieCallFunc_##FUNC)_M_STATE_LOAD(state->callFunc); \
+                (*callFunc) MCALL; \
+                if (slow.values != NULL) \
+                { \
+                    _M_RETURN_SEQUENCE(RET,FUNC,slow.values,slow.index); \
+                } \
+            } \
+            /* Defer to stubFunc: */ \
+            MoxieStubFunc_##FUNC stubFunc = (MoxieStubFunc_##FUNC)_M_STATE_LOAD(state->stubFunc); \
+            if (stubFunc != NULL) \
+            { \
+                _M_IF(_M_EQUAL(_M_RETURN_TYPE(RET),void))((*stubFunc) MCALL; return;, return (*stubFunc) MCALL;) \
+            } \
+        } \
+    } \
+    /* Defer to realFunc: */ \
+    _M_RECORD_CALL(FUNC,RETURN,CALL); \
+}
+#else
+#define _M_IMPLEMENT_MOCK_SLOW(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+static _M_COLD MoxieReturn_##FUNC __mSlowPath_##FUNC DECL \
+{ \
+    /* Resolve State: */ \
+    MoxieState *state = _M_STATE_ACTIVE(FUNC); \
+    int mockFlag = _M_STATE_LOAD(state->mockFlag); \
+    /* Skip Filtered Call: */ \
+    if (_M_FILTERED(FUNC,state,CALL)) \
+    { \
+        _M_IF(_M_EQUAL(_M_RETURN_TYPE(RET),void))(__real_##FUNC CALL; return;, return __real_##FUNC CALL;) \
+    } \
+    /* Skip Unsampled Call: */ \
+    if ((mockFlag & _M_FLAG_SAMPLE) && !__mSample(state, __mStateOf_##FUNC, &__mSampler_##FUNC)) \
+    { \
+        _M_IF(_M_EQUAL(_M_RETURN_TYPE(RET),void))(__real_##FUNC CALL; return;, return __real_##FUNC CALL;) \
+    } \
+    /* Count Call: */ \
+    if (mockFlag & _M_FLAG_SPY) \
+    { \
+        _M_SPY_COUNT(FUNC); \
+    } \
+    /* Capture Arguments: */ \
+    if (mockFlag & _M_FLAG_CAPTURE) \
+    { \
+        _M_CAPTURE_ARGS(FUNC,__VA_ARGS__); \
+    } \
+    /* Inject Latency and Faults: */ \
+    if ((mockFlag & _M_FLAG_INJECT) && __mInject(_M_STATE_LOAD(state->injection), __mStateOf_##FUNC)) \
+    { \
+        _M_RETURN_SEQUENCE(RET,FUNC,_M_STATE_LOAD(state->faultValue),0); \
+    } \
+    /* Defer to Return Sequence: */ \
+    unsigned long returnIndex; \
+    if ((mockFlag & _M_FLAG_RETURN) && !(mockFlag & _M_FLAG_DEFER) && __mNextReturn(state, &returnIndex)) \
+    { \
+        _M_RETURN_SEQUENCE(RET,FUNC,_M_STATE_LOAD(state->returnValues),returnIndex); \
+    } \
+    if (!(mockFlag & _M_FLAG_MOCK)) \
+    { \
+        _M_RECORD_CALL(FUNC,RETURN,CALL); \
+    } \
+    else \
+    { \
+        /* Defer Call: */ \
+        _M_DEFER_CALL(RET,FUNC,RETURN,CALL,MCALL,__VA_ARGS__) \
+        /* Process Call: */ \
+        _M_FLUSH_DEFERRED(); \
+        _M_ACTUAL_CALL(FUNC,CALL); \
+        /* Defer to callFunc: */ \
+        MoxieCallFunc_##FUNC callFunc = (MoxieCallFunc_##FUNC)_M_STATE_LOAD(state->callFunc); \
+        if (callFunc != NULL) \
+        { \
+            (*callFunc) MCALL; \
+        } \
+        /* Process Return: */ \
+        _M_DEFER_RETURN(RET,FUNC) \
+        /* Defer to stubFunc: */ \
+        MoxieStubFunc_##FUNC stubFunc = (MoxieStubFunc_##FUNC)_M_STATE_LOAD(state->stubFunc); \
+        if (stubFunc != NULL) \
+        { \
+            RETURN (*stubFunc) MCALL; \
+        } \
+        /* Defer to realFunc: */ \
+        else \
+        { \
+            _M_RECORD_CALL(FUNC,RETURN,CALL); \
+        } \
+    } \
+}
+#endif
+
+#ifndef MOXIE_NATIVE_BACKEND
+// Resolve Scope:
+// - The scope must be rebound upon every call; see Moxie_setScope.
+#define _M_ACTUAL_CALL(FUNC,CALL) \
+char *scope = _M_STATE_LOAD(state->scope); \
+MockSupport_c *mockSupport = (scope[0] == '\0') ? mock_c() : mock_scope_c(scope); \
+MockActualCall_c *actualCall = mockSupport->actualCall(_M_STR(FUNC))
+
+#define _M_IMPLEMENT_MOCK_NATIVE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...)
+
+#define _M_IMPLEMENT_MOCK_CALL(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+void __mCallFunc_##FUNC MDECL \
+{ \
+    _M_PARAMS_FUNC_IMPL(FUNC,__VA_ARGS__); \
+}
+
+#define _M_IMPLEMENT_MOCK_STUB(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+MoxieReturn_##FUNC __mStubFunc_##FUNC MDECL \
+{ \
+    if (actualCall->hasReturnValue()) \
+    { \
+        _M_RETURN_FUNC_IMPL(RET); \
+    } \
+    else \
+    { \
+        RETURN __real_##FUNC CALL; \
+    } \
+}
+#else
+// Native Backend:
+// - The expectations of every function are consumed in order from its arena,
+//   such that matching a call only compares against the expectation at the
+//   cursor.
+// - The matched expectation (or NULL) is handed from the Slow Path to the
+//   stubFunc through __mNativeCurrent_##FUNC, as the MockActualCall_c is
+//   handed to the stubFunc of the CppUMock integration.
+#define _M_ACTUAL_CALL(FUNC,CALL) \
+MockSupport_c *mockSupport = NULL; \
+MockActualCall_c *actualCall = NULL; \
+__mNativeCurrent_##FUNC = __mNativeMatch_##FUNC CALL
+
+#define _M_IMPLEMENT_MOCK_NATIVE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+static MoxieExpectation_##FUNC __mNativeArena_##FUNC[MOXIE_NATIVE_CAPACITY]; \
+static __thread const MoxieExpectation_##FUNC *__mNativeCurrent_##FUNC = NULL; \
+MoxieExpectation_##FUNC *__mExpect_##FUNC(unsigned long count) \
+{ \
+    MoxieState *state = __mStateOf_##FUNC; \
+    unsigned long size = state->expectSize; \
+    Assert(count != 0); \
+    Assert(size < (unsigned long)(MOXIE_NATIVE_CAPACITY)); \
+    if (count == 0 || size >= (unsigned long)(MOXIE_NATIVE_CAPACITY)) \
+    { \
+        return NULL; \
+    } \
+    MoxieExpectation_##FUNC *expectation = &__mNativeArena_##FUNC[size]; \
+    memset(expectation, 0, sizeof(*expectation)); \
+    expectation->withMask = ~0ul; \
+    expectation->count = count; \
+    state->expectSize = size + 1; \
+    state->expectPending += count; \
+    return expectation; \
+} \
+unsigned long __mVerify_##FUNC(void) \
+{ \
+    return __mStateOf_##FUNC->expectFailures + __mStateOf_##FUNC->expectPending; \
+} \
+static const MoxieExpectation_##FUNC *__mNativeMatch_##FUNC DECL \
+{ \
+    MoxieState *state = __mStateOf_##FUNC; \
+    unsigned long cursor = state->expectCursor; \
+    if (cursor < state->expectSize) \
+    { \
+        MoxieExpectation_##FUNC *expectation = &__mNativeArena_##FUNC[cursor]; \
+        unsigned long withMask = expectation->withMask; \
+        if (1 _M_PARAMS_MATCH(FUNC,__VA_ARGS__)) \
+        { \
+            if (--expectation->count == 0) \
+            { \
+                state->expectCursor = cursor + 1; \
+            } \
+            --state->expectPending; \
+            return expectation; \
+        } \
+    } \
+    ++state->expectFailures; \
+    Assert(0); \
+    return NULL; \
+}
+
+#define _M_IMPLEMENT_MOCK_CALL(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+void __mCallFunc_##FUNC MDECL \
+{ \
+    /* N/A: the arguments are matched by __mNativeMatch_##FUNC. */ \
+}
+
+#define _M_IMPLEMENT_MOCK_STUB(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+MoxieReturn_##FUNC __mStubFunc_##FUNC MDECL \
+{ \
+    const MoxieExpectation_##FUNC *expectation = __mNativeCurrent_##FUNC; \
+    if (expectation != NULL && expectation->hasReturn) \
+    { \
+        _M_IF(_M_EQUAL(_M_RETURN_TYPE(RET),void))(return;, return expectation->returnValue;) \
+    } \
+    else \
+    { \
+        RETURN __real_##FUNC CALL; \
+    } \
+}
+
+static inline int
+__mMatchString(const char *expected, const char *actual)
+{
+    return expected == actual || (expected != NULL && actual != NULL && strcmp(expected, actual) == 0);
+}
+
+static inline int
+__mMatchBuffer(const void *expected, unsigned long expectedSize, const void *actual, unsigned long actualSize)
+{
+    return expectedSize == actualSize && (expected == actual || memcmp(expected, actual, actualSize) == 0);
+}
+#endif
+
+#define _M_COMPARE_void(x) x
+
+#define _M_LIKELY(x) __builtin_expect(!!(x),1)
+#define _M_UNLIKELY(x) __builtin_expect(!!(x),0)
+#define _M_COLD __attribute__((noinline,cold))
+
+#define _M_VOID_POINTEE(P) __builtin_types_compatible_p(__typeof__(*(P)),void)
+#define _M_POINTEE_SIZE(P) ((size_t)!_M_VOID_POINTEE(P) * sizeof(*__builtin_choose_expr(_M_VOID_POINTEE(P),(char *)0,(P))))
+
+#define _M_RETURN(RET) _M_WHEN(_M_NOT_EQUAL(_M_RETURN_TYPE(RET),void))(return)
+
+#define _M_RETURN_FUNC_IMPL(RET) _M_RETURN_CALLBACK(RET)
+
+// Filter:
+// - A call is filtered if the MoxieState has a filter that rejects it, in
+//   which case the call is forwarded to the realFunc.
+#define _M_FILTERED(FUNC,STATE,CALL) \
+(_M_STATE_LOAD((STATE)->filter) != NULL && !((MoxieFilterFunc_##FUNC)_M_STATE_LOAD((STATE)->filter)) CALL)
+
+#define _M_RETURN_SEQUENCE(RET,FUNC,VALUES,INDEX) \
+_M_IF(_M_EQUAL(_M_RETURN_TYPE(RET),void))( \
+return;, \
+return ((const MoxieReturn_##FUNC *)(VALUES))[INDEX];)
+
+#define _M_PARAMS_MOCK_DECLARATION(FUNC,P,...) \
+_M_IF(_M_EQUAL(_M_PARAM_TYPE(P),void))( \
+_M_PARAMS(_M_PARAM_DECLARATION,FUNC,M_PARAM_MS,M_PARAM_MAC), \
+_M_PARAMS(_M_PARAM_DECLARATION,FUNC,M_PARAM_MS,M_PARAM_MAC,P,##__VA_ARGS__))
+
+#define _M_PARAMS_MOCK_PROTOTYPE(FUNC,P,...) \
+_M_IF(_M_EQUAL(_M_PARAM_TYPE(P),void))( \
+_M_PARAMS(_M_PARAM_PROTOTYPE,FUNC,M_PARAM_MS,M_PARAM_MAC), \
+_M_PARAMS(_M_PARAM_PROTOTYPE,FUNC,M_PARAM_MS,M_PARAM_MAC,P,##__VA_ARGS__))
+
+#define _M_PARAMS_MOCK_CALL(FUNC,P,...) \
+_M_IF(_M_EQUAL(_M_PARAM_TYPE(P),void))( \
+_M_PARAMS(_M_PARAM_CALL,FUNC,M_PARAM_MS,M_PARAM_MAC), \
+_M_PARAMS(_M_PARAM_CALL,FUNC,M_PARAM_MS,M_PARAM_MAC,P,##__VA_ARGS__))
+
+#define _M_PARAMS_FIELDS(FUNC,P,...) \
+_M_IF(_M_EQUAL(_M_PARAM_TYPE(P),void))( \
+/* N/A. */, \
+_M_PARAMS(_M_PARAM_FIELD,FUNC,P,##__VA_ARGS__))
+#define _M_PARAM_FIELD_TAIL(FUNC,INDEX,P) _M_PARAM_TYPE(P) _M_PARAM_NAME(P);
+#define _M_PARAM_FIELD(FUNC,INDEX,P) _M_PARAM_TYPE(P) _M_PARAM_NAME(P);
+
+#define _M_PARAMS_CAPTURE(FUNC,P,...) \
+_M_IF(_M_EQUAL(_M_PARAM_TYPE(P),void))( \
+/* N/A. */, \
+_M_PARAMS(_M_PARAM_CAPTURE,FUNC,P,##__VA_ARGS__))
+#define _M_PARAM_CAPTURE_TAIL(FUNC,INDEX,P) __args->_M_PARAM_NAME(P) = _M_PARAM_NAME(P);
+#define _M_PARAM_CAPTURE(FUNC,INDEX,P) __args->_M_PARAM_NAME(P) = _M_PARAM_NAME(P);
+
+#define _M_PARAMS_DECLARATION(FUNC,...) _M_PARAMS(_M_PARAM_DECLARATION,FUNC,__VA_ARGS__)
+#define _M_PARAM_DECLARATION_TAIL(FUNC,INDEX,P) _M_PARAM_TYPE(P) _M_PARAM_NAME(P)
+#define _M_PARAM_DECLARATION(FUNC,INDEX,P) _M_PARAM_TYPE(P) _M_PARAM_NAME(P),
+
+#define _M_PARAMS_PROTOTYPE(FUNC,...) _M_PARAMS(_M_PARAM_PROTOTYPE,FUNC,__VA_ARGS__)
+#define _M_PARAM_PROTOTYPE_TAIL(FUNC,INDEX,P) _M_PARAM_TYPE(P)
+#define _M_PARAM_PROTOTYPE(FUNC,INDEX,P) _M_PARAM_TYPE(P),
+
+#define _M_PARAMS_CALL(FUNC,...) _M_PARAMS(_M_PARAM_CALL,FUNC,__VA_ARGS__)
+#define _M_PARAM_CALL_TAIL(FUNC,INDEX,P) _M_PARAM_NAME(P)
+#define _M_PARAM_CALL(FUNC,INDEX,P) _M_PARAM_NAME(P),
+
+#define _M_PARAMS_MATCH(FUNC,...) _M_PARAMS(_M_PARAM_MATCH_IMPL,FUNC,__VA_ARGS__)
+#define _M_PARAM_MATCH_IMPL_TAIL(FUNC,INDEX,P) && (!(withMask & (1ul << INDEX)) || _M_PARAM_MATCH(P))
+#define _M_PARAM_MATCH_IMPL(FUNC,INDEX,P) && (!(withMask & (1ul << INDEX)) || _M_PARAM_MATCH(P))
+
+#define _M_PARAMS_DESCRIPTOR(FUNC,...) _M_PARAMS(_M_PARAM_DESCRIPTOR_IMPL,FUNC,__VA_ARGS__)
+#define _M_PARAM_DESCRIPTOR_IMPL_TAIL(FUNC,INDEX,P) _M_PARAM_DESCRIPTOR(P)
+#define _M_PARAM_DESCRIPTOR_IMPL(FUNC,INDEX,P) _M_PARAM_DESCRIPTOR(P)
+
+#define _M_PARAMS_PACK(FUNC,...) _M_PARAMS(_M_PARAM_PACK_IMPL,FUNC,__VA_ARGS__)
+#define _M_PARAM_PACK_IMPL_TAIL(FUNC,INDEX,P) _M_PARAM_PACK(P)
+#define _M_PARAM_PACK_IMPL(FUNC,INDEX,P) _M_PARAM_PACK(P)
+
+#define _M_PARAMS_HASH(FUNC,...) _M_PARAMS(_M_PARAM_HASH_IMPL,FUNC,__VA_ARGS__)
+#define _M_PARAM_HASH_IMPL_TAIL(FUNC,INDEX,P) _M_PARAM_HASH(P)
+#define _M_PARAM_HASH_IMPL(FUNC,INDEX,P) _M_PARAM_HASH(P)
+
+#define _M_PARAMS_OUTPUT(FUNC,...) _M_PARAMS(_M_PARAM_OUTPUT_IMPL,FUNC,__VA_ARGS__)
+#define _M_PARAM_OUTPUT_IMPL_TAIL(FUNC,INDEX,P) _M_PARAM_OUTPUT(P)
+#define _M_PARAM_OUTPUT_IMPL(FUNC,INDEX,P) _M_PARAM_OUTPUT(P)
+
+#define _M_PARAMS_FUNC_IMPL(FUNC,...) _M_PARAMS(_M_PARAM_FUNC_IMPL,FUNC,__VA_ARGS__)
+#define _M_PARAM_FUNC_IMPL_TAIL(FUNC,INDEX,P) _M_PARAM_CALLBACK(P)
+#define _M_PARAM_FUNC_IMPL(FUNC,INDEX,P) _M_PARAM_CALLBACK(P)
+
+#define _M_PARAMS(CALLBACK,FUNC,...) _M_DCAT(_M_PARAMS_,_M_N_VA_ARGS(__VA_ARGS__))(CALLBACK,FUNC,0,__VA_ARGS__)
+#define _M_PARAMS_0(CALLBACK,FUNC,INDEX,P,...) _M_PCAT(CALLBACK,_TAIL)(FUNC,INDEX,P)
+#define _M_PARAMS_1(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_0(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_2(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_1(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_3(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_2(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_4(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_3(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_5(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_4(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_6(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_5(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_7(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_6(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_8(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_7(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_9(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_8(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_10(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_9(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_11(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_10(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_12(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_11(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_13(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_12(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_14(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_13(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_15(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_14(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_16(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_15(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_17(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_16(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_18(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_17(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_19(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_18(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_20(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_19(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_21(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_20(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_22(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_21(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_23(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_22(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_24(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_23(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_25(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_24(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_26(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_25(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_27(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_26(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_28(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_27(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_29(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_28(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_30(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_29(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_31(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_30(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_PARAMS_32(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_31(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+
+/*
+ * Registry:
+ * Every M_IMPLEMENT_MOCK emits a MoxieRegistration into the "moxie_registry"
+ * linker section (or the "__DATA,__moxie" section on macOS), whose bounds are
+ * provided by the linker.
+ */
+
+#ifdef __darwin__
+#define _M_REGISTRY_SECTION "__DATA,__moxie"
+extern const MoxieRegistration __mRegistryStart[] __asm("section$start$__DATA$__moxie");
+extern const MoxieRegistration __mRegistryStop[] __asm("section$end$__DATA$__moxie");
+#define _M_REGISTRY_BEGIN __mRegistryStart
+#define _M_REGISTRY_END __mRegistryStop
+#else
+#define _M_REGISTRY_SECTION "moxie_registry"
+extern const MoxieRegistration __start_moxie_registry[] __attribute__((weak,visibility("hidden")));
+extern const MoxieRegistration __stop_moxie_registry[] __attribute__((weak,visibility("hidden")));
+#define _M_REGISTRY_BEGIN __start_moxie_registry
+#define _M_REGISTRY_END __stop_moxie_registry
+#endif
+
+#ifdef MOXIE_PROFILE_SHARDS
+#define _M_REGISTRATION_PROFILE(FUNC) \
+    .histograms = __mHistograms_##FUNC, \
+    .histogramCount = MOXIE_PROFILE_SHARDS,
+#else
+#define _M_REGISTRATION_PROFILE(FUNC)
+#endif
+
+#define _M_IMPLEMENT_MOCK_REGISTRATION(LAYOUT,RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+LAYOUT##_REGISTRATION(RET,FUNC,__VA_ARGS__)
+
+#define _M_REGISTRATION_INITIALIZER(STATE,RET,FUNC,...) \
+{ \
+    .name = _M_STR(FUNC), \
+    .state = (STATE), \
+    .callFunc = (void *)&__mCallFunc_##FUNC, \
+    .stubFunc = (void *)&__mStubFunc_##FUNC, \
+    .reset = &__mReset_##FUNC, \
+    .enable = &__mEnable_##FUNC, \
+    _M_REGISTRATION_PROFILE(FUNC) \
+    .armed = &__mArmed_##FUNC, \
+    .parameters = _M_PARAMS_DESCRIPTOR(FUNC,__VA_ARGS__) "", \
+    .returnKind = _M_RETURN_KIND(RET), \
+}
+
+// - __mResetRange and __mEnableRange apply Moxie_resetAll() and
+//   Moxie_enableAll() to a range of MoxieRegistrations, such as a mock table.
+static inline void
+__mResetRange(const MoxieRegistration *begin, const MoxieRegistration *end)
+{
+    const MoxieRegistration *registration;
+    for (registration = begin; registration != end; ++registration)
+    {
+#ifdef MOXIE_THREAD_LOCAL_STATE
+        (*registration->reset)();
+        _M_STATE_RESET_COUNTERS(registration->state);
+#else
+        MoxieState *state = registration->state;
+        _M_ARM(registration->armed, state, 0);
+        _M_STATE_RESET(state, registration->callFunc, registration->stubFunc);
+        _M_STATE_RESET_COUNTERS(state);
+#endif
+    }
+}
+
+static inline void
+__mEnableRange(const MoxieRegistration *begin, const MoxieRegistration *end)
+{
+    const MoxieRegistration *registration;
+    for (registration = begin; registration != end; ++registration)
+    {
+#ifdef MOXIE_THREAD_LOCAL_STATE
+        (*registration->enable)();
+#else
+        MoxieState *state = registration->state;
+        _M_ARM(registration->armed, state, _M_STATE_LOAD_RELAXED(state->mockFlag) | _M_FLAG_MOCK);
+#endif
+    }
+}
+
+#ifdef MOXIE_THREAD_LOCAL_STATE
+/*
+ * Thread Exit:
+ * The key is weak and hidden such that every translation unit of an executable
+ * or shared object registers the same destructor, once, which resets the
+ * MoxieStates of every mocked function of the exiting thread.
+ */
+
+pthread_key_t __mThreadExitKey __attribute__((weak,visibility("hidden")));
+pthread_once_t __mThreadExitOnce __attribute__((weak,visibility("hidden"))) = PTHREAD_ONCE_INIT;
+__thread int __mThreadExitWatched __attribute__((weak,visibility("hidden"))) = 0;
+
+static void
+__mThreadExit(void *unused)
+{
+    const MoxieRegistration *registration;
+    (void)unused;
+    for (registration = _M_REGISTRY_BEGIN; registration != _M_REGISTRY_END; ++registration)
+    {
+        (*registration->reset)();
+    }
+}
+
+static void
+__mThreadExitCreate(void)
+{
+    pthread_key_create(&__mThreadExitKey, &__mThreadExit);
+}
+
+/**
+ * @brief Registers the calling thread to be reset upon its exit.
+ */
+static inline void
+__mThreadExitWatch(void)
+{
+    if (!__mThreadExitWatched)
+    {
+        __mThreadExitWatched = 1;
+        pthread_once(&__mThreadExitOnce, &__mThreadExitCreate);
+        pthread_setspecific(__mThreadExitKey, &__mThreadExitWatched);
+    }
+}
+#endif
+
+/**
+ * @brief Resets the CppUMock integration for every mocked function.
+ *
+ * @note If MOXIE_THREAD_LOCAL_STATE is defined, then the configuration of the
+ * calling thread is reset through Moxie_reset(FUNC) for every mocked function,
+ * and the counters and cursors shared by every thread are reset.
+ * @note If MOXIE_DEFER_CAPACITY is defined, then the deferred calls that have
+ * not been flushed are discarded.
+ *
+ * @example Moxie_resetAll();
+ */
+static inline void
+Moxie_resetAll(void)
+{
+    __mResetRange(_M_REGISTRY_BEGIN, _M_REGISTRY_END);
+#ifdef _M_DEFERRED
+    __mDeferSize = 0;
+#endif
+}
+
+/**
+ * @brief Enables the CppUMock integration for every mocked function.
+ *
+ * @note If MOXIE_THREAD_LOCAL_STATE is defined, then the configuration of the
+ * calling thread is enabled through Moxie_enable(FUNC) for every mocked
+ * function.
+ *
+ * @example Moxie_enableAll();
+ */
+static inline void
+Moxie_enableAll(void)
+{
+    __mEnableRange(_M_REGISTRY_BEGIN, _M_REGISTRY_END);
+}
+
+/**
+ * @brief Finds the MoxieRegistration of the specified mocked function.
+ *
+ * @example const MoxieRegistration *registration = Moxie_findByName("sqrt");
+ *
+ * @param name the C identifier of the mocked function
+ * @return the MoxieRegistration, or NULL if the function is not mocked
+ */
+static inline const MoxieRegistration *
+Moxie_findByName(const char *name)
+{
+    const MoxieRegistration *registration;
+    for (registration = _M_REGISTRY_BEGIN; registration != _M_REGISTRY_END; ++registration)
+    {
+        if (strcmp(registration->name, name) == 0)
+        {
+            return registration;
+        }
+    }
+    return NULL;
+}
+
+#ifdef MOXIE_NATIVE_BACKEND
+/**
+ * @brief Returns the number of unexpected calls and unmet expected calls of
+ * every mocked function of the executable (MOXIE_NATIVE_BACKEND only).
+ *
+ * @example CHECK_EQUAL(0, Moxie_verifyAll());
+ */
+static inline unsigned long
+Moxie_verifyAll(void)
+{
+    unsigned long failures = 0;
+    const MoxieRegistration *registration;
+    for (registration = _M_REGISTRY_BEGIN; registration != _M_REGISTRY_END; ++registration)
+    {
+        failures += registration->state->expectFailures + registration->state->expectPending;
+    }
+    return failures;
+}
+#endif
+
+#ifdef MOXIE_FORK_SHARDING
+/*
+ * Fork Sharding:
+ * Every forked child derives its shard suffix from the suffix of its parent
+ * and the number of children that its parent had forked, such that the paths
+ * of the workers are stable across runs of the same sharded suite.
+ *
+ * The suffix is weak and hidden such that every translation unit of an
+ * executable or shared object suffixes the same paths.
+ */
+
+#define _M_SHARD_SUFFIX_SIZE 64
+#define _M_SHARD_PATH_SIZE 4096
+
+char __mShardSuffix[_M_SHARD_SUFFIX_SIZE] __attribute__((weak,visibility("hidden")));
+unsigned long __mForkCount __attribute__((weak,visibility("hidden"))) = 0;
+int __mForkInstalled __attribute__((weak,visibility("hidden"))) = 0;
+
+/**
+ * @brief Returns the shard suffix of the calling process, which is "" in the
+ * process that started the suite and e.g. ".3" or ".3.1" in its workers.
+ *
+ * @example printf("moxie.trace%s.json\n", Moxie_shardSuffix());
+ */
+static inline const char *
+Moxie_shardSuffix(void)
+{
+    return __mShardSuffix;
+}
+
+/**
+ * @brief Returns the specified path with the shard suffix of the calling
+ * process, which is written into the specified buffer unless the suffix is
+ * empty, or NULL if the suffixed path does not fit the buffer.
+ */
+static inline const char *
+__mShardPath(const char *path, char *buffer, size_t size)
+{
+    size_t length = strlen(path);
+    size_t suffix = strlen(__mShardSuffix);
+    if (suffix == 0)
+    {
+        return path;
+    }
+    if (length + suffix >= size)
+    {
+        return NULL;
+    }
+    memcpy(buffer, path, length);
+    memcpy(buffer + length, __mShardSuffix, suffix + 1);
+    return buffer;
+}
+#endif
+
+#ifdef MOXIE_STATS_EXPORT
+/*
+ * Stats Export:
+ * A stats segment is a MoxieStatsHeader followed by recordCount
+ * MoxieStatsRecords, one per MoxieRegistration in registry order. The layout
+ * only changes along with MOXIE_STATS_VERSION.
+ *
+ * Every MoxieStatsRecord is written under a seqlock: a reader loads its
+ * sequence, copies the record, and retries unless the sequence was even and
+ * is unchanged after the copy.
+ */
+
+#define MOXIE_STATS_MAGIC 0x5354584du
+#define MOXIE_STATS_VERSION 1u
+#define MOXIE_STATS_NAME_SIZE 64
+
+/**
+ * @brief A MoxieStatsHeader describes a stats segment.
+ */
+typedef struct MoxieStatsHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t recordSize;
+    uint64_t recordCount;
+    uint64_t generation;
+} MoxieStatsHeader;
+
+/**
+ * @brief A MoxieStatsRecord describes the statistics of a mocked function as
+ * of the latest Moxie_updateStats().
+ */
+typedef struct MoxieStatsRecord
+{
+    uint64_t sequence;
+    char name[MOXIE_STATS_NAME_SIZE];
+    uint64_t mockFlag;
+    uint64_t callCount;
+    uint64_t captureCount;
+    uint64_t sampleHits;
+    uint64_t sampleSkips;
+    uint64_t expectFailures;
+    uint64_t profileCount;
+    uint64_t profileP50;
+    uint64_t profileP99;
+    uint64_t profileP999;
+} MoxieStatsRecord;
+
+#define _M_STATS_RECORDS(STATS) ((MoxieStatsRecord *)((char *)(STATS) + sizeof(MoxieStatsHeader)))
+#define _M_STATS_STORE(FIELD,VALUE) __atomic_store_n(&(FIELD),(uint64_t)(VALUE),__ATOMIC_RELAXED)
+
+/**
+ * @brief Copies the statistics of every mocked function into the specified
+ * stats segment; no syscalls are performed.
+ *
+ * @note The profile quantiles only reflect the mocks whose translation units
+ * define MOXIE_PROFILE_SHARDS.
+ *
+ * @example Moxie_updateStats(stats);
+ *
+ * @param stats the stats segment of Moxie_exportStats()
+ */
+static inline void
+Moxie_updateStats(MoxieStatsHeader *stats)
+{
+    MoxieStatsRecord *record = _M_STATS_RECORDS(stats);
+    const MoxieRegistration *registration = _M_REGISTRY_BEGIN;
+    uint64_t i;
+    for (i = 0; i < stats->recordCount && registration != _M_REGISTRY_END; ++i, ++record, ++registration)
+    {
+        MoxieState *state = registration->state;
+        unsigned long epoch = __atomic_load_n(&state->callEpoch, __ATOMIC_RELAXED);
+        uint64_t sequence = __atomic_load_n(&record->sequence, __ATOMIC_RELAXED);
+        __atomic_store_n(&record->sequence, sequence + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        _M_STATS_STORE(record->mockFlag, __atomic_load_n(&state->mockFlag, __ATOMIC_RELAXED));
+        _M_STATS_STORE(record->callCount, __atomic_load_n(&state->callCount, __ATOMIC_RELAXED));
+        _M_STATS_STORE(record->captureCount, __atomic_load_n(&state->captureCount, __ATOMIC_RELAXED));
+        _M_STATS_STORE(record->sampleHits, __atomic_load_n(&state->sampleHits, __ATOMIC_RELAXED));
+        _M_STATS_STORE(record->sampleSkips, __atomic_load_n(&state->sampleSkips, __ATOMIC_RELAXED));
+        _M_STATS_STORE(record->expectFailures, __atomic_load_n(&state->expectFailures, __ATOMIC_RELAXED));
+        _M_STATS_STORE(record->profileCount, __mHistogramCount(registration->histograms, registration->histogramCount, epoch));
+        _M_STATS_STORE(record->profileP50, __mHistogramQuantile(registration->histograms, registration->histogramCount, epoch, 0.5));
+        _M_STATS_STORE(record->profileP99, __mHistogramQuantile(registration->histograms, registration->histogramCount, epoch, 0.99));
+        _M_STATS_STORE(record->profileP999, __mHistogramQuantile(registration->histograms, registration->histogramCount, epoch, 0.999));
+        __atomic_store_n(&record->sequence, sequence + 2, __ATOMIC_RELEASE);
+    }
+    __atomic_add_fetch(&stats->generation, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Creates the specified POSIX shared memory segment and publishes the
+ * statistics of every mocked function into it.
+ *
+ * The statistics are only refreshed by Moxie_updateStats(), e.g. from the
+ * main loop or a timer of the process.
+ *
+ * @note If MOXIE_FORK_SHARDING is defined, then the name is suffixed by
+ * Moxie_shardSuffix().
+ *
+ * @code
+ * MoxieStatsHeader *stats = Moxie_exportStats("/moxie.soak");
+ * while (running)
+ * {
+ *     Moxie_updateStats(stats);
+ *     sleep(1);
+ * }
+ * Moxie_unexportStats(stats, "/moxie.soak");
+ * @endcode
+ *
+ * @param name the name of the segment for shm_open()
+ * @return the stats segment, or NULL if it could not be created
+ */
+static inline MoxieStatsHeader *
+Moxie_exportStats(const char *name)
+{
+    const MoxieRegistration *registration;
+    MoxieStatsHeader *stats;
+    MoxieStatsRecord *record;
+    uint64_t count = 0;
+    size_t size;
+    void *segment;
+    int fd;
+#ifdef MOXIE_FORK_SHARDING
+    char shardPath[_M_SHARD_PATH_SIZE];
+#endif
+#ifdef MOXIE_FORK_SHARDING
+    name = __mShardPath(name, shardPath, sizeof(shardPath));
+    if (name == NULL)
+    {
+        return NULL;
+    }
+#endif
+    for (registration = _M_REGISTRY_BEGIN; registration != _M_REGISTRY_END; ++registration)
+    {
+        ++count;
+    }
+    size = sizeof(MoxieStatsHeader) + (size_t)count * sizeof(MoxieStatsRecord);
+    fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+    if (ftruncate(fd, (off_t)size) != 0)
+    {
+        close(fd);
+        return NULL;
+    }
+    segment = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED)
+    {
+        return NULL;
+    }
+    stats = (MoxieStatsHeader *)segment;
+    memset(stats, 0, size);
+    stats->version = MOXIE_STATS_VERSION;
+    stats->headerSize = (uint32_t)sizeof(MoxieStatsHeader);
+    stats->recordSize = (uint32_t)sizeof(MoxieStatsRecord);
+    stats->recordCount = count;
+    for (registration = _M_REGISTRY_BEGIN, record = _M_STATS_RECORDS(stats); registration != _M_REGISTRY_END; ++registration, ++record)
+    {
+        strncpy(record->name, registration->name, MOXIE_STATS_NAME_SIZE - 1);
+    }
+    Moxie_updateStats(stats);
+    __atomic_store_n(&stats->magic, MOXIE_STATS_MAGIC, __ATOMIC_RELEASE);
+    return stats;
+}
+
+/**
+ * @brief Unmaps the specified stats segment and removes its name.
+ *
+ * @note If MOXIE_FORK_SHARDING is defined, then the name is suffixed by
+ * Moxie_shardSuffix().
+ *
+ * @example Moxie_unexportStats(stats, "/moxie.soak");
+ *
+ * @param stats the stats segment of Moxie_exportStats()
+ * @param name the name of the segment for shm_unlink()
+ */
+static inline void
+Moxie_unexportStats(MoxieStatsHeader *stats, const char *name)
+{
+#ifdef MOXIE_FORK_SHARDING
+    char shardPath[_M_SHARD_PATH_SIZE];
+#endif
+    munmap(stats, sizeof(MoxieStatsHeader) + (size_t)stats->recordCount * sizeof(MoxieStatsRecord));
+#ifdef MOXIE_FORK_SHARDING
+    name = __mShardPath(name, shardPath, sizeof(shardPath));
+    if (name == NULL)
+    {
+        return;
+    }
+#endif
+    shm_unlink(name);
+}
+#endif
+
+#ifdef MOXIE_TRACE_CAPACITY
+/*
+ * Tracing:
+ * Every thread claims one of the MOXIE_TRACE_SHARDS MoxieTraceShards upon its
+ * first traced call, into which it appends a MoxieTraceEvent per call with a
+ * relaxed atomic increment of its cursor; the oldest events are overwritten
+ * once the ring buffer wraps around.
+ *
+ * The shards are weak and hidden such that every translation unit of an
+ * executable or shared object appends to the same shards.
+ */
+
+/**
+ * @brief A MoxieTraceEvent describes a traced call of a mocked function.
+ *
+ * The registration is stored last, with release semantics, such that a slot
+ * is only dumped once it has been written.
+ */
+typedef struct MoxieTraceEvent
+{
+    const MoxieRegistration *registration;
+    unsigned long thread;
+    unsigned long long start;
+    unsigned long long duration;
+} MoxieTraceEvent;
+
+/**
+ * @brief A MoxieTraceShard is a ring buffer of the MoxieTraceEvents of the
+ * threads that share it.
+ */
+typedef struct MoxieTraceShard
+{
+    unsigned long cursor _M_CACHE_ALIGNED;
+    MoxieTraceEvent events[MOXIE_TRACE_CAPACITY];
+} MoxieTraceShard;
+
+MoxieTraceShard __mTraceShards[MOXIE_TRACE_SHARDS] __attribute__((weak,visibility("hidden")));
+unsigned long __mTraceThreads __attribute__((weak,visibility("hidden"))) = 0;
+__thread unsigned long __mThreadTraceId __attribute__((weak,visibility("hidden"))) = 0;
+
+/**
+ * @brief Appends the call of the specified MoxieRegistration since the
+ * specified timestamp to the MoxieTraceShard of the calling thread.
+ */
+static inline void
+__mTraceRecord(const MoxieRegistration *registration, unsigned long long start)
+{
+    unsigned long long end = __mProfileNow();
+    unsigned long thread = __mThreadTraceId;
+    MoxieTraceShard *shard;
+    MoxieTraceEvent *event;
+    if (thread == 0)
+    {
+        thread = __atomic_add_fetch(&__mTraceThreads, 1, __ATOMIC_RELAXED);
+        __mThreadTraceId = thread;
+    }
+    shard = &__mTraceShards[(thread - 1) % (MOXIE_TRACE_SHARDS)];
+    event = &shard->events[__atomic_fetch_add(&shard->cursor, 1, __ATOMIC_RELAXED) % (MOXIE_TRACE_CAPACITY)];
+    __atomic_store_n(&event->registration, NULL, __ATOMIC_RELAXED);
+    event->thread = thread;
+    event->start = start;
+    event->duration = (end > start) ? (end - start) : 0;
+    __atomic_store_n(&event->registration, registration, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Writes the MoxieTraceEvents of every thread to the specified file in
+ * the Chrome Trace Event JSON format, which is loaded by chrome://tracing and
+ * the Perfetto UI.
+ *
+ * Every event is a complete ("X") event named after its mocked function,
+ * whose tid is the order in which its thread first traced a call.
+ *
+ * @note The events should be dumped while no traced function is called, e.g.
+ * after the threads that call them have been joined; otherwise, the events
+ * that are overwritten during the dump may be torn.
+ *
+ * @note If MOXIE_FORK_SHARDING is defined, then the path is suffixed by
+ * Moxie_shardSuffix().
+ *
+ * @example Moxie_dumpTrace("moxie.trace.json");
+ *
+ * @param path the path of the file, which is truncated
+ * @return 0, or -1 if the file could not be written
+ */
+static inline int
+Moxie_dumpTrace(const char *path)
+{
+    const char *separator = "";
+    unsigned long i;
+    int failed;
+    FILE *file;
+#ifdef MOXIE_FORK_SHARDING
+    char shardPath[_M_SHARD_PATH_SIZE];
+#endif
+#ifdef MOXIE_FORK_SHARDING
+    path = __mShardPath(path, shardPath, sizeof(shardPath));
+    if (path == NULL)
+    {
+        return -1;
+    }
+#endif
+    file = fopen(path, "w");
+    if (file == NULL)
+    {
+        return -1;
+    }
+    fputs("{\"traceEvents\":[", file);
+    for (i = 0; i < MOXIE_TRACE_SHARDS; ++i)
+    {
+        const MoxieTraceShard *shard = &__mTraceShards[i];
+        unsigned long cursor = __atomic_load_n(&shard->cursor, __ATOMIC_ACQUIRE);
+        unsigned long index = (cursor > MOXIE_TRACE_CAPACITY) ? (cursor - MOXIE_TRACE_CAPACITY) : 0;
+        for (; index < cursor; ++index)
+        {
+            const MoxieTraceEvent *event = &shard->events[index % (MOXIE_TRACE_CAPACITY)];
+            const MoxieRegistration *registration = __atomic_load_n(&event->registration, __ATOMIC_ACQUIRE);
+            if (registration == NULL)
+            {
+                continue;
+            }
+            fprintf(file, "%s\n{\"name\":\"%s\",\"cat\":\"moxie\",\"ph\":\"X\",\"pid\":%ld,\"tid\":%lu,"
+                "\"ts\":%llu.%03llu,\"dur\":%llu.%03llu}",
+                separator, registration->name, (long)getpid(), event->thread,
+                event->start / 1000, event->start % 1000, event->duration / 1000, event->duration % 1000);
+            separator = ",";
+        }
+    }
+    fputs("\n],\"displayTimeUnit\":\"ns\"}\n", file);
+    failed = ferror(file);
+    if (fclose(file) != 0 || failed)
+    {
+        return -1;
+    }
+    return 0;
+}
+#endif
+
+#ifdef MOXIE_RECORD_REPLAY
+/*
+ * Record and Replay:
+ * A recording is a MoxieRecordHeader followed by MoxieRecords, which are
+ * appended with a single writev() per call to a file opened with O_APPEND,
+ * such that the MoxieRecords of concurrent calls are not interleaved. The
+ * layout only changes along with MOXIE_RECORD_VERSION.
+ *
+ * Every MoxieRecord is followed by the uint64_t sizes of its outputCount
+ * outputs, its return value, and the pointees of its outputs, each of which is
+ * padded to 8 bytes. A replay only maps the recording and scans it.
+ */
+
+#define MOXIE_RECORD_MAGIC 0x5252584du
+#define MOXIE_RECORD_VERSION 1u
+
+#define _M_RECORD_OUTPUTS 32
+#define _M_RECORD_ALIGN(SIZE) (((SIZE) + 7) & ~(size_t)7)
+
+/**
+ * @brief A MoxieRecordHeader describes a recording.
+ */
+typedef struct MoxieRecordHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t recordSize;
+} MoxieRecordHeader;
+
+/**
+ * @brief A MoxieRecord describes a recorded call of a mocked function, whose
+ * function and arguments are the FNV-1a hashes of its name and arguments.
+ */
+typedef struct MoxieRecord
+{
+    uint32_t size;
+    uint32_t resultSize;
+    uint32_t outputCount;
+    uint32_t reserved;
+    uint64_t function;
+    uint64_t arguments;
+} MoxieRecord;
+
+/**
+ * @brief A MoxieOutput describes the pointee of an output parameter of a call.
+ */
+typedef struct MoxieOutput
+{
+    void *data;
+    size_t size;
+} MoxieOutput;
+
+int __mRecordFd __attribute__((weak,visibility("hidden"))) = -1;
+#ifdef MOXIE_FORK_SHARDING
+char __mRecordPath[_M_SHARD_PATH_SIZE] __attribute__((weak,visibility("hidden")));
+#endif
+const unsigned char *__mReplayMap __attribute__((weak,visibility("hidden"))) = NULL;
+size_t __mReplaySize __attribute__((weak,visibility("hidden"))) = 0;
+
+/**
+ * @brief Appends a MoxieRecord of a call of the specified function to the
+ * recording, if any.
+ *
+ * @return 0, or -1 if the call was not recorded
+ */
+static inline int
+__mRecordCall(const char *name, unsigned long long arguments, const void *result, size_t resultSize,
+    const MoxieOutput *outputs, unsigned long count)
+{
+    static const unsigned char padding[8] = { 0 };
+    struct iovec iov[3 + 2 * _M_RECORD_OUTPUTS];
+    uint64_t sizes[_M_RECORD_OUTPUTS];
+    MoxieRecord record;
+    size_t total = sizeof(MoxieRecord) + count * sizeof(uint64_t) + _M_RECORD_ALIGN(resultSize);
+    unsigned long i;
+    int n = 0;
+    ssize_t written;
+    int fd = __atomic_load_n(&__mRecordFd, __ATOMIC_ACQUIRE);
+    if (fd < 0 || count > _M_RECORD_OUTPUTS)
+    {
+        return -1;
+    }
+    iov[n].iov_base = &record;
+    iov[n++].iov_len = sizeof(MoxieRecord);
+    iov[n].iov_base = sizes;
+    iov[n++].iov_len = count * sizeof(uint64_t);
+    iov[n].iov_base = (void *)result;
+    iov[n++].iov_len = resultSize;
+    iov[n].iov_base = (void *)padding;
+    iov[n++].iov_len = _M_RECORD_ALIGN(resultSize) - resultSize;
+    for (i = 0; i < count; ++i)
+    {
+        sizes[i] = (outputs[i].data != NULL) ? (uint64_t)outputs[i].size : 0;
+        total += _M_RECORD_ALIGN((size_t)sizes[i]);
+        iov[n].iov_base = outputs[i].data;
+        iov[n++].iov_len = (size_t)sizes[i];
+        iov[n].iov_base = (void *)padding;
+        iov[n++].iov_len = _M_RECORD_ALIGN((size_t)sizes[i]) - (size_t)sizes[i];
+    }
+    record.size = (uint32_t)total;
+    record.resultSize = (uint32_t)resultSize;
+    record.outputCount = (uint32_t)count;
+    record.reserved = 0;
+    record.function = __mHashString(_M_HASH_SEED, name);
+    record.arguments = arguments;
+    ++__mThreadInternal;
+    written = writev(fd, iov, n);
+    --__mThreadInternal;
+    return (written == (ssize_t)total) ? 0 : -1;
+}
+
+/**
+ * @brief Returns the offset of the first MoxieRecord of the specified function
+ * (and arguments, unless matched by order) at or after the specified offset
+ * of the replay, or 0 if there is none.
+ */
+static inline size_t
+__mReplayFind(const unsigned char *map, size_t size, size_t offset, unsigned long long function,
+    unsigned long long arguments, MoxieReplay match, size_t resultSize)
+{
+    while (offset + sizeof(MoxieRecord) <= size)
+    {
+        const MoxieRecord *record = (const MoxieRecord *)(map + offset);
+        if (record->size < sizeof(MoxieRecord) || record->size > size - offset)
+        {
+            break;
+        }
+        if (record->function == function && record->resultSize == resultSize
+            && (match == MOXIE_REPLAY_ORDER || record->arguments == arguments))
+        {
+            return offset;
+        }
+        offset += record->size;
+    }
+    return 0;
+}
+
+/**
+ * @brief Replays a call of the specified function from the replay, if any,
+ * into the specified return value and outputs.
+ *
+ * @return 1 if the call was replayed, or 0 if the call must be deferred to the
+ * realFunc
+ */
+static inline int
+__mReplayCall(const char *name, MoxieState *global, MoxieReplay match, unsigned long long arguments,
+    const MoxieOutput *outputs, unsigned long count, void *result, size_t resultSize)
+{
+    const unsigned char *map = __atomic_load_n(&__mReplayMap, __ATOMIC_ACQUIRE);
+    unsigned long long function = __mHashString(_M_HASH_SEED, name);
+    const MoxieRecord *record;
+    const uint64_t *sizes;
+    const unsigned char *data;
+    unsigned long cursor;
+    size_t offset;
+    uint32_t i;
+    if (map == NULL)
+    {
+        return 0;
+    }
+    do
+    {
+        cursor = (match == MOXIE_REPLAY_ORDER) ? __atomic_load_n(&global->replayCursor, __ATOMIC_RELAXED) : 0;
+        offset = __mReplayFind(map, __mReplaySize, sizeof(MoxieRecordHeader) + cursor, function, arguments, match, resultSize);
+        if (offset == 0)
+        {
+            return 0;
+        }
+        record = (const MoxieRecord *)(map + offset);
+    } while (match == MOXIE_REPLAY_ORDER
+        && !__atomic_compare_exchange_n(&global->replayCursor, &cursor, offset + record->size - sizeof(MoxieRecordHeader),
+            0, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    sizes = (const uint64_t *)(record + 1);
+    data = (const unsigned char *)(sizes + record->outputCount);
+    if (resultSize != 0)
+    {
+        memcpy(result, data, resultSize);
+    }
+    data += _M_RECORD_ALIGN(resultSize);
+    for (i = 0; i < record->outputCount; ++i)
+    {
+        if (i < count && outputs[i].data != NULL)
+        {
+            memcpy(outputs[i].data, data, (sizes[i] < outputs[i].size) ? (size_t)sizes[i] : outputs[i].size);
+        }
+        data += _M_RECORD_ALIGN((size_t)sizes[i]);
+    }
+    return 1;
+}
+
+/**
+ * @brief Opens the specified file for Moxie_record(FUNC), appending to it if
+ * it already exists.
+ *
+ * @note If MOXIE_FORK_SHARDING is defined, then the path is suffixed by
+ * Moxie_shardSuffix(), and a forked worker reopens the recording of its
+ * parent under its own suffix.
+ *
+ * @example Moxie_startRecording("network.moxie");
+ *
+ * @param path the path of the recording
+ * @return 0, or -1 if the file could not be opened
+ */
+static inline int
+Moxie_startRecording(const char *path)
+{
+    MoxieRecordHeader header = {
+        MOXIE_RECORD_MAGIC,
+        MOXIE_RECORD_VERSION,
+        (uint32_t)sizeof(MoxieRecordHeader),
+        (uint32_t)sizeof(MoxieRecord),
+    };
+    struct stat status;
+    int fd;
+#ifdef MOXIE_FORK_SHARDING
+    char shardPath[_M_SHARD_PATH_SIZE];
+#endif
+#ifdef MOXIE_FORK_SHARDING
+    if (path != __mRecordPath)
+    {
+        size_t length = strlen(path);
+        __mRecordPath[0] = '\0';
+        if (length < sizeof(__mRecordPath))
+        {
+            memcpy(__mRecordPath, path, length + 1);
+        }
+    }
+#endif
+#ifdef MOXIE_FORK_SHARDING
+    path = __mShardPath(path, shardPath, sizeof(shardPath));
+    if (path == NULL)
+    {
+        return -1;
+    }
+#endif
+    fd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    if (fstat(fd, &status) != 0 || (status.st_size == 0 && write(fd, &header, sizeof(header)) != (ssize_t)sizeof(header)))
+    {
+        close(fd);
+        return -1;
+    }
+    fd = __atomic_exchange_n(&__mRecordFd, fd, __ATOMIC_ACQ_REL);
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    return 0;
+}
+
+/**
+ * @brief Closes the file of Moxie_startRecording().
+ *
+ * @example Moxie_stopRecording();
+ */
+static inline void
+Moxie_stopRecording(void)
+{
+    int fd = __atomic_exchange_n(&__mRecordFd, -1, __ATOMIC_ACQ_REL);
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+}
+
+/**
+ * @brief Stops the replay, if any, and unmaps its recording.
+ *
+ * @note The replay should be stopped while no replayed function is called.
+ *
+ * @example Moxie_stopReplay();
+ */
+static inline void
+Moxie_stopReplay(void)
+{
+    const unsigned char *map = __atomic_exchange_n(&__mReplayMap, NULL, __ATOMIC_ACQ_REL);
+    if (map != NULL)
+    {
+        munmap((void *)map, __mReplaySize);
+    }
+}
+
+/**
+ * @brief Maps the specified recording for Moxie_replay(FUNC) and rewinds the
+ * replay cursor of every mocked function.
+ *
+ * @note If MOXIE_FORK_SHARDING is defined, then the path is suffixed by
+ * Moxie_shardSuffix().
+ *
+ * @example Moxie_startReplay("network.moxie");
+ *
+ * @param path the path of the recording
+ * @return 0, or -1 if the file could not be mapped or is not a recording
+ */
+static inline int
+Moxie_startReplay(const char *path)
+{
+    const MoxieRegistration *registration;
+    const MoxieRecordHeader *header;
+    struct stat status;
+    void *map;
+    int fd;
+#ifdef MOXIE_FORK_SHARDING
+    char shardPath[_M_SHARD_PATH_SIZE];
+#endif
+#ifdef MOXIE_FORK_SHARDING
+    path = __mShardPath(path, shardPath, sizeof(shardPath));
+    if (path == NULL)
+    {
+        return -1;
+    }
+#endif
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    if (fstat(fd, &status) != 0 || (size_t)status.st_size < sizeof(MoxieRecordHeader))
+    {
+        close(fd);
+        return -1;
+    }
+    map = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        return -1;
+    }
+    header = (const MoxieRecordHeader *)map;
+    if (header->magic != MOXIE_RECORD_MAGIC || header->version != MOXIE_RECORD_VERSION
+        || header->headerSize != sizeof(MoxieRecordHeader) || header->recordSize != sizeof(MoxieRecord))
+    {
+        munmap(map, (size_t)status.st_size);
+        return -1;
+    }
+    Moxie_stopReplay();
+    for (registration = _M_REGISTRY_BEGIN; registration != _M_REGISTRY_END; ++registration)
+    {
+        __atomic_store_n(&registration->state->replayCursor, 0, __ATOMIC_RELAXED);
+    }
+    __mReplaySize = (size_t)status.st_size;
+    __atomic_store_n(&__mReplayMap, (const unsigned char *)map, __ATOMIC_RELEASE);
+    return 0;
+}
+#endif
 
+#ifdef MOXIE_CALLER_FILTER
 /*
- * Implementation Macros:
+ * Caller Filtering:
+ * Moxie_setCallerModules() collects the executable PT_LOAD segments of the
+ * named modules into a sorted array of MoxieCallerRanges and publishes a new
+ * generation of the array, which every thread compares against the generation
+ * of its MoxieCallerCache before reusing the last range or gap that it found.
+ *
+ * The ranges are weak and hidden such that every translation unit of an
+ * executable or shared object searches the same ranges.
  */
 
-#ifndef Assert
-#define Assert(c,...)
-#endif
+/**
+ * @brief A MoxieCallerRange is the half-open address range of an executable
+ * segment of a named module.
+ */
+typedef struct MoxieCallerRange
+{
+    uintptr_t start;
+    uintptr_t end;
+} MoxieCallerRange;
 
-#define _M_DECLARE_MOCK(RET,FUNC,...) \
-typedef void (*MoxieCallFunc_##FUNC)(_M_PARAMS_MOCK_PROTOTYPE(FUNC,__VA_ARGS__)); \
-typedef _M_RETURN_TYPE(RET) (*MoxieStubFunc_##FUNC)(_M_PARAMS_MOCK_PROTOTYPE(FUNC,__VA_ARGS__)); \
-extern void __mReset_##FUNC(void); \
-extern void __mEnable_##FUNC(void); \
-extern void __mSetScope_##FUNC(const char *); \
-extern void __mSetCallFunc_##FUNC(MoxieCallFunc_##FUNC); \
-extern void __mSetStubFunc_##FUNC(MoxieStubFunc_##FUNC); \
-extern _M_RETURN_TYPE(RET) __real_##FUNC(_M_PARAMS_PROTOTYPE(FUNC,__VA_ARGS__)); \
-extern _M_RETURN_TYPE(RET) __wrap_##FUNC(_M_PARAMS_PROTOTYPE(FUNC,__VA_ARGS__)); \
-extern void __mCallFunc_##FUNC(_M_PARAMS_MOCK_PROTOTYPE(FUNC,__VA_ARGS__)); \
-extern _M_RETURN_TYPE(RET) __mStubFunc_##FUNC(_M_PARAMS_MOCK_PROTOTYPE(FUNC,__VA_ARGS__));
-
-#define _M_IMPLEMENT_MOCK(RET,FUNC,...) \
-_M_IMPLEMENT_MOCK_PREFACE(RET,FUNC,__VA_ARGS__) \
-_M_IMPLEMENT_MOCK_REAL(RET,FUNC,__VA_ARGS__) \
-_M_IMPLEMENT_MOCK_WRAP(RET,FUNC,__VA_ARGS__) \
-_M_IMPLEMENT_MOCK_CALL(RET,FUNC,__VA_ARGS__) \
-_M_IMPLEMENT_MOCK_STUB(RET,FUNC,__VA_ARGS__) \
-_M_DYLD_INTERPOSE(FUNC)
+/**
+ * @brief A MoxieCallerCache is the last range or gap between ranges that a
+ * thread found, and whether its calls are mocked.
+ */
+typedef struct MoxieCallerCache
+{
+    unsigned long generation;
+    uintptr_t start;
+    uintptr_t end;
+    int allowed;
+} MoxieCallerCache;
 
-#define _M_IMPLEMENT_MOCK_PREFACE(RET,FUNC,...) \
-static MoxieState __mState_##FUNC = { \
-    .mockFlag = 0, \
-    .scope = "", \
-    .callFunc = &__mCallFunc_##FUNC, \
-    .stubFunc = &__mStubFunc_##FUNC, \
-}; \
-void __mReset_##FUNC(void) \
-{ \
-    __mState_##FUNC.mockFlag = 0; \
-    __mState_##FUNC.scope = ""; \
-    __mState_##FUNC.callFunc = &__mCallFunc_##FUNC; \
-    __mState_##FUNC.stubFunc = &__mStubFunc_##FUNC; \
-} \
-void __mEnable_##FUNC(void) \
-{ \
-    __mState_##FUNC.mockFlag = 1; \
-} \
-void __mSetScope_##FUNC(const char *scope) \
-{ \
-    Assert(__mState_##FUNC.mockFlag); \
-    __mState_##FUNC.scope = (char *)scope; \
-} \
-__mSetCallFunc_##FUNC(MoxieCallFunc_##FUNC callFunc) \
-{ \
-    Assert(__mState_##FUNC.mockFlag); \
-    __mState_##FUNC.callFunc = callFunc; \
-} \
-__mSetStubFunc_##FUNC(MoxieStubFunc_##FUNC stubFunc) \
-{ \
-    Assert(__mState_##FUNC.mockFlag); \
-    __mState_##FUNC.stubFunc = stubFunc; \
+MoxieCallerRange __mCallerRanges[MOXIE_CALLER_RANGES] __attribute__((weak,visibility("hidden")));
+unsigned long __mCallerRangeCount __attribute__((weak,visibility("hidden"))) = 0;
+unsigned long __mCallerEpoch __attribute__((weak,visibility("hidden"))) = 0;
+unsigned long __mCallerGeneration __attribute__((weak,visibility("hidden"))) = 0;
+__thread MoxieCallerCache __mThreadCallerCache __attribute__((weak,visibility("hidden"))) = { 0, 0, 0, 0 };
+
+/**
+ * @brief Returns whether the calls from the specified return address are
+ * mocked, i.e. whether the caller filter is cleared or the address lies within
+ * a MoxieCallerRange.
+ */
+static inline int
+__mCallerAllowed(const void *address)
+{
+    uintptr_t caller = (uintptr_t)address;
+    unsigned long generation = __atomic_load_n(&__mCallerGeneration, __ATOMIC_ACQUIRE);
+    MoxieCallerCache *cache = &__mThreadCallerCache;
+    unsigned long low = 0;
+    unsigned long high;
+    if (generation == 0)
+    {
+        return 1;
+    }
+    if (cache->generation == generation && caller >= cache->start && caller < cache->end)
+    {
+        return cache->allowed;
+    }
+    high = __mCallerRangeCount;
+    while (low < high)
+    {
+        unsigned long middle = low + (high - low) / 2;
+        if (caller < __mCallerRanges[middle].start)
+        {
+            high = middle;
+        }
+        else if (caller >= __mCallerRanges[middle].end)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            cache->start = __mCallerRanges[middle].start;
+            cache->end = __mCallerRanges[middle].end;
+            cache->allowed = 1;
+            cache->generation = generation;
+            return 1;
+        }
+    }
+    cache->start = (low > 0) ? __mCallerRanges[low - 1].end : 0;
+    cache->end = (low < __mCallerRangeCount) ? __mCallerRanges[low].start : UINTPTR_MAX;
+    cache->allowed = 0;
+    cache->generation = generation;
+    return 0;
 }
 
-#ifdef __darwin__
-#define _M_IMPLEMENT_MOCK_REAL(RET,FUNC,...) \
-_M_RETURN_TYPE(RET) __real_##FUNC(_M_PARAMS_DECLARATION(FUNC,__VA_ARGS__)) \
-{ \
-    _M_RETURN(RET) FUNC(_M_PARAMS_CALL(FUNC,__VA_ARGS__)); \
+/**
+ * @brief A MoxieCallerModule is the name of a module that dl_iterate_phdr()
+ * is searched for, and whether its segments fit the MoxieCallerRanges.
+ */
+typedef struct MoxieCallerModule
+{
+    const char *name;
+    int found;
+    int overflow;
+} MoxieCallerModule;
+
+/**
+ * @brief Inserts the executable segments of the specified module into the
+ * sorted MoxieCallerRanges if it is the searched MoxieCallerModule.
+ *
+ * A module is matched by its path, by its file name, or by the prefix of its
+ * file name up to a '.', such that "libfoo" matches "/usr/lib/libfoo.so.1";
+ * the executable itself, whose path is empty, is matched by "".
+ */
+static int
+__mCallerCollect(struct dl_phdr_info *info, size_t size, void *data)
+{
+    MoxieCallerModule *module = (MoxieCallerModule *)data;
+    const char *path = (info->dlpi_name != NULL) ? info->dlpi_name : "";
+    const char *file = strrchr(path, '/');
+    size_t length = strlen(module->name);
+    ElfW(Half) i;
+    (void)size;
+    file = (file != NULL) ? (file + 1) : path;
+    if (strcmp(path, module->name) != 0 && strcmp(file, module->name) != 0
+        && (length == 0 || strncmp(file, module->name, length) != 0 || file[length] != '.'))
+    {
+        return 0;
+    }
+    module->found = 1;
+    for (i = 0; i < info->dlpi_phnum; ++i)
+    {
+        const ElfW(Phdr) *segment = &info->dlpi_phdr[i];
+        uintptr_t start = (uintptr_t)(info->dlpi_addr + segment->p_vaddr);
+        unsigned long index = __mCallerRangeCount;
+        if (segment->p_type != PT_LOAD || !(segment->p_flags & PF_X))
+        {
+            continue;
+        }
+        if (__mCallerRangeCount == MOXIE_CALLER_RANGES)
+        {
+            module->overflow = 1;
+            break;
+        }
+        while (index > 0 && __mCallerRanges[index - 1].start > start)
+        {
+            __mCallerRanges[index] = __mCallerRanges[index - 1];
+            --index;
+        }
+        __mCallerRanges[index].start = start;
+        __mCallerRanges[index].end = start + (uintptr_t)segment->p_memsz;
+        ++__mCallerRangeCount;
+    }
+    return module->found;
+}
+
+/**
+ * @brief Limits the armed mocks to the calls made from the specified modules,
+ * whose executable segments are collected once, or clears the caller filter
+ * if no modules are specified.
+ *
+ * The modules that are loaded afterwards, e.g. through dlopen(), are not
+ * matched until Moxie_setCallerModules() is called again.
+ *
+ * @note The caller filter should be changed while no mocked function is
+ * called, e.g. before the threads that call them are started.
+ *
+ * @example
+ * @code
+ * static const char *const modules[] = { "libstorage", "" };
+ *
+ * Moxie_setCallerModules(modules, 2);
+ * @endcode
+ *
+ * @param modules the paths or file names of the modules, where "" names the
+ *        executable
+ * @param count the number of modules, or 0 to clear the caller filter
+ * @return 0, or -1 if a module is not loaded or its segments exceed
+ *         MOXIE_CALLER_RANGES
+ */
+static inline int
+Moxie_setCallerModules(const char *const *modules, size_t count)
+{
+    size_t i;
+    int result = 0;
+    __atomic_store_n(&__mCallerGeneration, 0, __ATOMIC_RELEASE);
+    __mCallerRangeCount = 0;
+    if (count == 0)
+    {
+        return 0;
+    }
+    for (i = 0; i < count; ++i)
+    {
+        MoxieCallerModule module = { modules[i], 0, 0 };
+        dl_iterate_phdr(__mCallerCollect, &module);
+        if (!module.found || module.overflow)
+        {
+            result = -1;
+        }
+    }
+    __atomic_store_n(&__mCallerGeneration, ++__mCallerEpoch, __ATOMIC_RELEASE);
+    return result;
 }
-#else
-#define _M_IMPLEMENT_MOCK_REAL(RET,FUNC,...)
 #endif
 
-#define _M_IMPLEMENT_MOCK_WRAP(RET,FUNC,...) \
-_M_RETURN_TYPE(RET) __wrap_##FUNC(_M_PARAMS_DECLARATION(FUNC,__VA_ARGS__)) \
-{ \
-    int mockFlag = __mState_##FUNC.mockFlag; \
-    /* Fast Path: */ \
-    if (!mockFlag) \
-    { \
-        _M_RETURN(RET) __real_##FUNC(_M_PARAMS_CALL(FUNC,__VA_ARGS__)); \
-    } \
-    /* Slow Path: */ \
-    else \
-    { \
-        /* Resolve Scope: */ \
-        char *scope = __mState_##FUNC.scope; \
-        MockSupport_c *mockSupport = (scope[0] == '\0') ? mock_c() : mock_scope_c(scope); \
-        /* Process Call: */ \
-        MockActualCall_c *actualCall = mockSupport->actualCall(_M_STR(FUNC)); \
-        /* Defer to callFunc: */ \
-        MoxieCallFunc_##FUNC callFunc = __mState_##FUNC.callFunc; \
-        if (callFunc != NULL) \
-        { \
-            (*callFunc)(_M_PARAMS_MOCK_CALL(FUNC,__VA_ARGS__)); \
-        } \
-        /* Process Return: */ \
-        /* Defer to stubFunc: */ \
-        MoxieStubFunc_##FUNC stubFunc = __mState_##FUNC.stubFunc; \
-        if (stubFunc != NULL) \
-        { \
-            _M_RETURN(RET) (*stubFunc)(_M_PARAMS_MOCK_CALL(FUNC,__VA_ARGS__)); \
-        } \
-        /* Defer to realFunc: */ \
-        else \
-        { \
-            _M_RETURN(RET) __real_##FUNC(_M_PARAMS_CALL(FUNC,__VA_ARGS__)); \ 
-        } \
-    } \
+#ifdef MOXIE_FORK_SHARDING
+/*
+ * Fork Handlers:
+ * The prepare handler counts the children of the forking process, and the
+ * child handler moves the child into its own shard through the registry.
+ * Both handlers are registered once per executable or shared object by a
+ * constructor, and only call async-signal-safe functions.
+ */
+
+static void
+__mForkPrepare(void)
+{
+    __atomic_add_fetch(&__mForkCount, 1, __ATOMIC_RELAXED);
 }
 
-#define _M_IMPLEMENT_MOCK_CALL(RET,FUNC,...) \
-void __mCallFunc_##FUNC(_M_PARAMS_MOCK_DECLARATION(FUNC,__VA_ARGS__)) \
-{ \
-    _M_PARAMS_FUNC_IMPL(FUNC,__VA_ARGS__); \
+static void
+__mForkChild(void)
+{
+    const MoxieRegistration *registration;
+    char digits[3 * sizeof(unsigned long)];
+    unsigned long shard = __mForkCount;
+    size_t length = strlen(__mShardSuffix);
+    size_t count = 0;
+    do
+    {
+        digits[count++] = (char)('0' + shard % 10);
+        shard /= 10;
+    } while (shard != 0);
+    if (length + count + 1 < sizeof(__mShardSuffix))
+    {
+        __mShardSuffix[length++] = '.';
+        while (count > 0)
+        {
+            __mShardSuffix[length++] = digits[--count];
+        }
+        __mShardSuffix[length] = '\0';
+    }
+    __mForkCount = 0;
+    for (registration = _M_REGISTRY_BEGIN; registration != _M_REGISTRY_END; ++registration)
+    {
+        _M_STATE_RESET_STATISTICS(registration->state);
+    }
+#ifdef MOXIE_TRACE_CAPACITY
+    {
+        unsigned long i;
+        for (i = 0; i < MOXIE_TRACE_SHARDS; ++i)
+        {
+            __atomic_store_n(&__mTraceShards[i].cursor, 0, __ATOMIC_RELAXED);
+        }
+        __mTraceThreads = 0;
+        __mThreadTraceId = 0;
+    }
+#endif
+#ifdef MOXIE_RECORD_REPLAY
+    if (__atomic_load_n(&__mRecordFd, __ATOMIC_ACQUIRE) >= 0
+        && (__mRecordPath[0] == '\0' || Moxie_startRecording(__mRecordPath) != 0))
+    {
+        Moxie_stopRecording();
+    }
+#endif
 }
 
-#define _M_IMPLEMENT_MOCK_STUB(RET,FUNC,...) \
-_M_RETURN_TYPE(RET) __mStubFunc_##FUNC(_M_PARAMS_MOCK_DECLARATION(FUNC,__VA_ARGS__)) \
-{ \
-    if (actualCall->hasReturnValue()) \
-    { \
-        _M_RETURN_FUNC_IMPL(RET); \
-    } \
-    else \
-    { \
-        _M_RETURN(RET) __real_##FUNC(_M_PARAMS_CALL(FUNC,__VA_ARGS__));
-    } \
+static void __attribute__((constructor,used))
+__mForkConstructor(void)
+{
+    if (__atomic_exchange_n(&__mForkInstalled, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+        pthread_atfork(&__mForkPrepare, NULL, &__mForkChild);
+    }
 }
+#endif
 
-#define _M_COMPARE_void(x) x
+#ifdef MOXIE_ENV_ENABLE
+/*
+ * Environment Arming:
+ * Every translation unit emits a constructor, of which only the first to run
+ * in an executable or shared object parses MOXIE_ENABLE and applies it to the
+ * MoxieStates of the registry.
+ */
 
-#define _M_RETURN(RET) _M_WHEN(_M_NOT_EQUAL(_M_RETURN_TYPE(RET),void))(return)
+#define _M_ENV_CAPACITY 4096
 
-#define _M_RETURN_FUNC_IMPL(RET) _M_RETURN_CALLBACK(RET)
+int __mEnvArmed __attribute__((weak,visibility("hidden"))) = 0;
 
-#define _M_PARAMS_MOCK_DECLARATION(FUNC,P,...) \
-_M_IF(_M_EQUAL(_M_PARAM_TYPE(P),void))( \
-_M_PARAMS(_M_PARAM_DECLARATION,FUNC,M_PARAM_MS,M_PARAM_MAC), \
-_M_PARAMS(_M_PARAM_DECLARATION,FUNC,M_PARAM_MS,M_PARAM_MAC,P,##__VA_ARGS__))
+/**
+ * @brief Arms the global MoxieState of the specified MoxieRegistration with
+ * the specified modes of a MOXIE_ENABLE entry.
+ */
+static inline void
+__mEnvApply(const MoxieRegistration *registration, const char *scope, int flag, unsigned long period)
+{
+    MoxieState *state = registration->state;
+    if (registration->histogramCount == 0)
+    {
+        flag &= ~_M_FLAG_PROFILE;
+    }
+    if (scope != NULL)
+    {
+        _M_STATE_STORE(state->scope, (char *)scope);
+    }
+    if (period > 1)
+    {
+        _M_STATE_STORE(state->samplePeriod, period);
+        _M_STATE_STORE(state->sampleMode, MOXIE_SAMPLE_PERIODIC);
+        __atomic_add_fetch(&state->sampleEpoch, 1, __ATOMIC_RELAXED);
+        flag |= _M_FLAG_SAMPLE;
+    }
+    _M_ARM(registration->armed, state, _M_STATE_LOAD_RELAXED(state->mockFlag) | flag);
+}
 
-#define _M_PARAMS_MOCK_PROTOTYPE(FUNC,P,...) \
-_M_IF(_M_EQUAL(_M_PARAM_TYPE(P),void))( \
-_M_PARAMS(_M_PARAM_PROTOTYPE,FUNC,M_PARAM_MS,M_PARAM_MAC), \
-_M_PARAMS(_M_PARAM_PROTOTYPE,FUNC,M_PARAM_MS,M_PARAM_MAC,P,##__VA_ARGS__))
+/**
+ * @brief Reports the specified entry of MOXIE_ENABLE, which is skipped for
+ * the specified reason and MODE, to stderr.
+ */
+static inline void
+__mEnvReject(const char *entry, const char *reason, const char *mode)
+{
+    ++__mThreadInternal;
+    fprintf(stderr, "moxie: skipping " _M_ENABLE_ENV " entry '%s': %s '%s'\n", entry, reason, mode);
+    --__mThreadInternal;
+}
 
-#define _M_PARAMS_MOCK_CALL(FUNC,P,...) \
-_M_IF(_M_EQUAL(_M_PARAM_TYPE(P),void))( \
-_M_PARAMS(_M_PARAM_CALL,FUNC,M_PARAM_MS,M_PARAM_MAC), \
-_M_PARAMS(_M_PARAM_CALL,FUNC,M_PARAM_MS,M_PARAM_MAC,P,##__VA_ARGS__))
+/**
+ * @brief Parses the specified MOXIE_ENABLE value and arms every mocked
+ * function of the registry that it names.
+ *
+ * The value is copied into a static buffer, which then holds the scopes of
+ * the armed MoxieStates.
+ */
+static inline void
+__mEnvArm(const char *value)
+{
+    static char buffer[_M_ENV_CAPACITY];
+    char *entry;
+    char *next;
+    if (value == NULL)
+    {
+        return;
+    }
+    if (strlen(value) >= sizeof(buffer))
+    {
+        ++__mThreadInternal;
+        fprintf(stderr, "moxie: ignoring " _M_ENABLE_ENV ": longer than %lu characters\n", (unsigned long)sizeof(buffer) - 1);
+        --__mThreadInternal;
+        return;
+    }
+    strcpy(buffer, value);
+    for (entry = buffer; entry != NULL; entry = next)
+    {
+        const MoxieRegistration *registration;
+        char *option;
+        char *scope;
+        const char *reason = NULL;
+        const char *rejected = NULL;
+        unsigned long period = 0;
+        int flag = 0;
+        next = strchr(entry, ',');
+        if (next != NULL)
+        {
+            *next++ = '\0';
+        }
+        option = strchr(entry, '/');
+        if (option != NULL)
+        {
+            *option++ = '\0';
+        }
+        while (option != NULL && reason == NULL)
+        {
+            char *mode = option;
+            option = strchr(option, '/');
+            if (option != NULL)
+            {
+                *option++ = '\0';
+            }
+            if (strcmp(mode, "mock") == 0)
+            {
+                flag |= _M_FLAG_MOCK;
+            }
+            else if (strcmp(mode, "spy") == 0)
+            {
+                flag |= _M_FLAG_SPY;
+            }
+            else if (strcmp(mode, "profile") == 0)
+            {
+                flag |= _M_FLAG_PROFILE;
+            }
+#ifdef MOXIE_TRACE_CAPACITY
+            else if (strcmp(mode, "trace") == 0)
+            {
+                flag |= _M_FLAG_TRACE;
+            }
+#endif
+            else if (strncmp(mode, "sample=", 7) == 0)
+            {
+                char *end;
+                period = strtoul(mode + 7, &end, 10);
+                if (mode[7] < '0' || mode[7] > '9' || *end != '\0')
+                {
+                    reason = "non-numeric";
+                    rejected = mode;
+                }
+            }
+            else
+            {
+                reason = (strcmp(mode, "trace") == 0) ? "unsupported mode" : "unknown mode";
+                rejected = mode;
+            }
+        }
+        if (reason != NULL)
+        {
+            __mEnvReject(entry, reason, rejected);
+            continue;
+        }
+        if (flag == 0)
+        {
+            flag = _M_FLAG_MOCK;
+        }
+        scope = strchr(entry, ':');
+        if (scope != NULL)
+        {
+            *scope++ = '\0';
+        }
+        for (registration = _M_REGISTRY_BEGIN; registration != _M_REGISTRY_END; ++registration)
+        {
+            if (strcmp(entry, "*") == 0 || strcmp(entry, registration->name) == 0)
+            {
+                __mEnvApply(registration, scope, flag, period);
+            }
+        }
+    }
+}
 
-#define _M_PARAMS_DECLARATION(FUNC,...) _M_PARAMS(_M_PARAM_DECLARATION,FUNC,__VA_ARGS__)
-#define _M_PARAM_DECLARATION_TAIL(FUNC,INDEX,P) _M_PARAM_TYPE(P) _M_PARAM_NAME(P)
-#define _M_PARAM_DECLARATION(FUNC,INDEX,P) _M_PARAM_TYPE(P) _M_PARAM_NAME(P),
+static void __attribute__((constructor,used))
+__mEnvConstructor(void)
+{
+    if (__atomic_exchange_n(&__mEnvArmed, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+        __mEnvArm(getenv(_M_ENABLE_ENV));
+    }
+}
+#endif
 
-#define _M_PARAMS_PROTOTYPE(FUNC,...) _M_PARAMS(_M_PARAM_PROTOTYPE,FUNC,__VA_ARGS__)
-#define _M_PARAM_PROTOTYPE_TAIL(FUNC,INDEX,P) _M_PARAM_TYPE(P)
-#define _M_PARAM_PROTOTYPE(FUNC,INDEX,P) _M_PARAM_TYPE(P),
+/*
+ * Mock Tables:
+ * A M_IMPLEMENT_MOCK_TABLE numbers its entries with an enum, and places their
+ * MoxieStates and MoxieRegistrations into a single array of each indexed by
+ * the enum, such that the MoxieStates of the table are one contiguous block,
+ * the MoxieRegistrations are one contiguous range of the registry, and the
+ * table is reset and enabled by the shared __mResetRange and __mEnableRange
+ * over that range.
+ */
 
-#define _M_PARAMS_CALL(FUNC,...) _M_PARAMS(_M_PARAM_CALL,FUNC,__VA_ARGS__)
-#define _M_PARAM_CALL_TAIL(FUNC,INDEX,P) _M_PARAM_NAME(P)
-#define _M_PARAM_CALL(FUNC,INDEX,P) _M_PARAM_NAME(P),
+#define _M_DECLARE_MOCK_TABLE(TABLE) \
+TABLE(_M_DECLARE_MOCK) \
+extern void __mResetTable_##TABLE(void); \
+extern void __mEnableTable_##TABLE(void);
 
-#define _M_PARAMS_FUNC_IMPL(FUNC,...) _M_PARAMS(_M_PARAM_FUNC_IMPL,FUNC,__VA_ARGS__)
-#define _M_PARAM_FUNC_IMPL_TAIL(FUNC,INDEX,P) _M_PARAM_CALLBACK(P)
-#define _M_PARAM_FUNC_IMPL(FUNC,INDEX,P) _M_PARAM_CALLBACK(P)
+#define _M_IMPLEMENT_MOCK_TABLE(TABLE) \
+enum { TABLE(_M_TABLE_INDEX) __mTableCount }; \
+static MoxieState __mTableStates[__mTableCount] = { TABLE(_M_TABLE_STATE) }; \
+static const MoxieRegistration __mTableRegistrations[__mTableCount]; \
+TABLE(_M_IMPLEMENT_MOCK_TABLE_ENTRY) \
+static const MoxieRegistration __mTableRegistrations[__mTableCount] \
+__attribute__((used,section(_M_REGISTRY_SECTION),aligned(sizeof(void *)))) = \
+{ \
+    TABLE(_M_TABLE_REGISTRATION) \
+}; \
+void __mResetTable_##TABLE(void) \
+{ \
+    __mResetRange(__mTableRegistrations, __mTableRegistrations + __mTableCount); \
+} \
+void __mEnableTable_##TABLE(void) \
+{ \
+    __mEnableRange(__mTableRegistrations, __mTableRegistrations + __mTableCount); \
+}
+#define _M_IMPLEMENT_MOCK_TABLE_ENTRY(RET,FUNC,...) \
+_M_IMPLEMENT_MOCK_LAYOUT(_M_LAYOUT_TABLE,RET,FUNC,__VA_ARGS__)
 
-#define _M_PARAMS(CALLBACK,FUNC,...) _M_DCAT(_M_PARAMS_,_M_N_VA_ARGS(__VA_ARGS__))(CALLBACK,FUNC,0,__VA_ARGS__)
-#define _M_PARAMS_0(CALLBACK,FUNC,INDEX,P,...) _M_PCAT(CALLBACK,_TAIL)(FUNC,INDEX,P)
-#define _M_PARAMS_1(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_0(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_2(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_1(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_3(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_2(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_4(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_3(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_5(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_4(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_6(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_5(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_7(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_6(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_8(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_7CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_9(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_8(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_10(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_9(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_11(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_10(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_12(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_11(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_13(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_12(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_14(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_13(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_15(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_14(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_16(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_15(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_17(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_16(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_18(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_17(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_19(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_18(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_20(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_19(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_21(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_20(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_22(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_21(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_23(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_22(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_24(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_23(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_25(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_24(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_26(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_25(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_27(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_26(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_28(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_27(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_29(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_28(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_30(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_29(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
-#define _M_PARAMS_31(CALLBACK,FUNC,INDEX,P,...) CALLBACK(FUNC,INDEX,P)_M_PARAMS_30(CALLBACK,FUNC,_M_INC(INDEX),__VA_ARGS__)
+#define _M_TABLE_INDEX(RET,FUNC,...) __mTableIndex_##FUNC,
+#define _M_TABLE_STATE(RET,FUNC,...) [__mTableIndex_##FUNC] = _M_STATE_INITIALIZER(FUNC),
+#define _M_TABLE_REGISTRATION(RET,FUNC,...) \
+[__mTableIndex_##FUNC] = _M_REGISTRATION_INITIALIZER(&__mTableStates[__mTableIndex_##FUNC],RET,FUNC,__VA_ARGS__),
+
+#define _M_LAYOUT_TABLE_STATE(FUNC) \
+static MoxieState *const __mStateOf_##FUNC = &__mTableStates[__mTableIndex_##FUNC]; \
+static const MoxieRegistration *const __mRegistrationOf_##FUNC __attribute__((unused)) = &__mTableRegistrations[__mTableIndex_##FUNC];
+#define _M_LAYOUT_TABLE_REGISTRATION(RET,FUNC,...)
+
+#define _M_WRAP_MOCK_TABLE(TABLE) TABLE(_M_WRAP_MOCK_TABLE_ENTRY)
+#ifdef _M_RTLD_NEXT
+#define _M_WRAP_MOCK_TABLE_ENTRY(RET,FUNC,...) ""
+#else
+#define _M_WRAP_MOCK_TABLE_ENTRY(RET,FUNC,...) _M_VA_STR(-Wl,--wrap=FUNC) " "
+#endif
 
 /*
  * macOS Macros:
@@ -546,7 +5222,7 @@ typedef struct __interpose {
 
 #define _M_DYLD_INTERPOSE(FUNC) \
 static const __interpose __interpose_##FUNC \
-__attribute__((user,section("__DATA,__interpose"))) = \
+__attribute__((used,section("__DATA,__interpose"))) = \
 { \
     .__wrapFunc = (const void *)((uintptr_t)(&(__wrap_##FUNC))), \
     .__realFunc = (const void *)((uintptr_t)(&(FUNC))), \
@@ -555,12 +5231,161 @@ __attribute__((user,section("__DATA,__interpose"))) = \
 #define _M_DYLD_INTERPOSE(FUNC)
 #endif
 
+/*
+ * Runtime Interposition Macros:
+ * MOXIE_RTLD_NEXT replaces the `-Wl,--wrap=...` LDFLAGS by defining FUNC as an
+ * alias of the WRAP, such that the dynamic linker binds every call of FUNC
+ * (including the calls from shared objects) to the WRAP, and by resolving the
+ * REAL as the next definition of FUNC in the lookup order.
+ */
+
+#ifdef _M_RTLD_NEXT
+#ifndef RTLD_NEXT
+/* glibc only declares RTLD_NEXT for _GNU_SOURCE. */
+#define RTLD_NEXT ((void *) -1l)
+#endif
+
+static inline void *
+__mResolveReal(MoxieState *state, const char *name)
+{
+    void *realFunc = dlsym(RTLD_NEXT, name);
+    Assert(realFunc != NULL);
+    __atomic_store_n(&state->realFunc, realFunc, __ATOMIC_RELAXED);
+    return realFunc;
+}
+
+#define _M_IMPLEMENT_MOCK_INTERPOSE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+MoxieReturn_##FUNC FUNC DECL __attribute__((alias(_M_STR(__wrap_##FUNC))));
+#else
+#define _M_IMPLEMENT_MOCK_INTERPOSE(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...)
+#endif
+
+/*
+ * Load-Time Dispatch Macros:
+ * MOXIE_IFUNC_DISPATCH emits the WRAP as __mDispatch_##FUNC and declares
+ * __wrap_##FUNC as a GNU ifunc, whose resolver is called once by the dynamic
+ * linker and binds __wrap_##FUNC to either the REAL or the WRAP.
+ */
+
+#ifdef _M_IFUNC_DISPATCH
+
+// - The resolvers of a static executable are called while it relocates itself,
+//   before the thread pointer is set up, such that the environment is read
+//   through raw system calls, which neither set errno nor read the stack
+//   protector canary, into a static buffer rather than a stack array.
+#define _M_AT_FDCWD (-100)
+
+#if defined(__x86_64__)
+static inline long
+__mDispatchSyscall(long number, long a, long b, long c)
+{
+    long result;
+    __asm__ volatile ("syscall"
+                      : "=a"(result)
+                      : "a"(number), "D"(a), "S"(b), "d"(c)
+                      : "rcx", "r11", "memory");
+    return result;
+}
+#elif defined(__aarch64__)
+static inline long
+__mDispatchSyscall(long number, long a, long b, long c)
+{
+    register long x8 __asm__("x8") = number;
+    register long x0 __asm__("x0") = a;
+    register long x1 __asm__("x1") = b;
+    register long x2 __asm__("x2") = c;
+    __asm__ volatile ("svc 0"
+                      : "+r"(x0)
+                      : "r"(x8), "r"(x1), "r"(x2)
+                      : "memory");
+    return x0;
+}
+#else
+#error "MOXIE_IFUNC_DISPATCH requires x86-64 or AArch64"
+#endif
+
+/**
+ * @brief Returns whether the MOXIE_ARMED environment variable of the process
+ * is set to a value other than "0", or the MOXIE_ENABLE environment variable
+ * is set to a non-empty value.
+ *
+ * The environment is scanned once per translation unit, in chunks, as an ifunc
+ * resolver can rely on neither getenv() nor the C library wrappers of the
+ * system calls.
+ */
+static inline int
+__mDispatchArmed(void)
+{
+    static int armed = -1;
+    if (armed < 0)
+    {
+        static const char key[] = _M_DISPATCH_ENV "=";
+        static const char enableKey[] = _M_ENABLE_ENV "=";
+        const unsigned long mismatch = ~0ul;
+        unsigned long offset = 0;
+        unsigned long enableOffset = 0;
+        static char buffer[256];
+        long size;
+        long fd = __mDispatchSyscall(SYS_openat, _M_AT_FDCWD, (long)"/proc/self/environ", O_RDONLY);
+        armed = 0;
+        while (fd >= 0 && !armed && (size = __mDispatchSyscall(SYS_read, fd, (long)buffer, sizeof(buffer))) > 0)
+        {
+            long i;
+            for (i = 0; i < size && !armed; ++i)
+            {
+                if (buffer[i] == '\0')
+                {
+                    offset = 0;
+                    enableOffset = 0;
+                    continue;
+                }
+                if (offset == sizeof(key) - 1)
+                {
+                    armed = (buffer[i] != '0');
+                }
+                else if (offset != mismatch)
+                {
+                    offset = (buffer[i] == key[offset]) ? offset + 1 : mismatch;
+                }
+                if (enableOffset == sizeof(enableKey) - 1)
+                {
+                    armed = 1;
+                }
+                else if (enableOffset != mismatch)
+                {
+                    enableOffset = (buffer[i] == enableKey[enableOffset]) ? enableOffset + 1 : mismatch;
+                }
+            }
+        }
+        if (fd >= 0)
+        {
+            __mDispatchSyscall(SYS_close, fd, 0, 0);
+        }
+    }
+    return armed;
+}
+
+#define _M_WRAP_LINKAGE static
+#define _M_WRAP_SYMBOL(FUNC) __mDispatch_##FUNC
+#define _M_IMPLEMENT_MOCK_DISPATCH(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...) \
+static MoxieRealFunc_##FUNC __mResolve_##FUNC(void) \
+{ \
+    return __mDispatchArmed() ? &__mDispatch_##FUNC : &__real_##FUNC; \
+} \
+MoxieReturn_##FUNC __wrap_##FUNC DECL __attribute__((ifunc(_M_STR(__mResolve_##FUNC))));
+#else
+#define _M_WRAP_LINKAGE
+#define _M_WRAP_SYMBOL(FUNC) __wrap_##FUNC
+#define _M_IMPLEMENT_MOCK_DISPATCH(RET,FUNC,RETURN,DECL,CALL,MDECL,MCALL,...)
+#endif
+
 /*
  * Meta Macros:
  * @see https://github.com/Hirrolot/awesome-c-preprocessor
  */
 
 #define _M_STR(x) #x
+#define _M_VA_STR(...) #__VA_ARGS__
 
 #define _M_PCAT(x,...) x ## __VA_ARGS__
 #define _M_DCAT(x,...) _M_PCAT(x,__VA_ARGS__)
@@ -597,7 +5422,8 @@ __attribute__((user,section("__DATA,__interpose"))) = \
 #define _M_INC_28 29
 #define _M_INC_29 30
 #define _M_INC_30 31
-#define _M_INC_31 31
+#define _M_INC_31 32
+#define _M_INC_32 32
 
 #define _M_DEC(x) _M_PCAT(_M_DEC_,x)
 #define _M_DEC_0 0
@@ -632,6 +5458,7 @@ __attribute__((user,section("__DATA,__interpose"))) = \
 #define _M_DEC_29 28
 #define _M_DEC_30 29
 #define _M_DEC_31 30
+#define _M_DEC_32 31
 
 #define _M_IGNORE(...)
 #define _M_EMPTY()
@@ -639,16 +5466,6 @@ __attribute__((user,section("__DATA,__interpose"))) = \
 #define _M_EXPAND(...) __VA_ARGS__
 #define _M_DEFER(...) __VA_ARGS__ _M_BLOCK(_M_EMPTY)()
 
-#define _M_EVAL(...) _M_EVAL1(_M_EVAL1(_M_EVAL1(__VA_ARGS__)))
-#define _M_EVAL1(...) _M_EVAL2(_M_EVAL2(_M_EVAL2(__VA_ARGS__)))
-#define _M_EVAL2(...) _M_EVAL3(_M_EVAL3(_M_EVAL3(__VA_ARGS__)))
-#define _M_EVAL3(...) _M_EVAL4(_M_EVAL4(_M_EVAL4(__VA_ARGS__)))
-#define _M_EVAL4(...) _M_EVAL5(_M_EVAL5(_M_EVAL5(__VA_ARGS__)))
-#define _M_EVAL5(...) _M_EVAL6(_M_EVAL6(_M_EVAL6(__VA_ARGS__)))
-#define _M_EVAL6(...) _M_EVAL7(_M_EVAL7(_M_EVAL7(__VA_ARGS__)))
-#define _M_EVAL7(...) _M_EVAL8(_M_EVAL8(_M_EVAL8(__VA_ARGS__)))
-#define _M_EVAL8(...) _M_EXPAND(_M_EXPAND(_M_EXPAND(__VA_ARGS__)))
-
 #define _M_CHECK_N(x,n,...) n
 #define _M_CHECK(...) _M_CHECK_N(__VA_ARGS__,0,)
 #define _M_PROBE(x) x, 1,
@@ -659,7 +5476,7 @@ __attribute__((user,section("__DATA,__interpose"))) = \
 #define _M_IF_0(t,...) __VA_ARGS__
 #define _M_IF_1(t,...) t
 
-#define _M_NEGATE(x) _M_PCAT(_M_NEGATE,x)
+#define _M_NEGATE(x) _M_PCAT(_M_NEGATE_,x)
 #define _M_NEGATE_0 1
 #define _M_NEGATE_1 0
 
@@ -683,7 +5500,7 @@ __attribute__((user,section("__DATA,__interpose"))) = \
 #define _M_NOT_EQUAL(x,y) _M_IF_(_M_AND(_M_IS_COMPARABLE(x))(_M_IS_COMPARABLE(y)))(_M_NEQ_COMPARABLE,1 _M_IGNORE)(x,y)
 #define _M_EQUAL(x,y) _M_NEGATE(_M_NOT_EQUAL(x,y))
 
-#define _M_N_VA_ARGS_(_0,_1,_2,_3,_4,_5,_6,_7,_8,_9,_10,_11,_12,_13,_14,_15,_16,_17,_18,_19,_20,_21,_22,_23,_24,_25,_26,_27,_28,_29,_30,_31,N,...) N
-#define _M_N_VA_ARGS(...) _M_N_VA_ARGS_(__VA_ARGS__,31,30,29,28,27,26,25,24,23,22,21,20,19,18,17,16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1,0)
+#define _M_N_VA_ARGS_(_0,_1,_2,_3,_4,_5,_6,_7,_8,_9,_10,_11,_12,_13,_14,_15,_16,_17,_18,_19,_20,_21,_22,_23,_24,_25,_26,_27,_28,_29,_30,_31,_32,N,...) N
+#define _M_N_VA_ARGS(...) _M_N_VA_ARGS_(__VA_ARGS__,32,31,30,29,28,27,26,25,24,23,22,21,20,19,18,17,16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1,0)
 
 #endif // SRC_INCLUDE_MOXIE_H_
\ No newline at end of file
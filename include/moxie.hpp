@@ -0,0 +1,598 @@
+#ifndef SRC_INCLUDE_MOXIE_HPP_
+#define SRC_INCLUDE_MOXIE_HPP_
+
+#include "moxie.h"
+
+#if defined(MOXIE_THREAD_LOCAL_STATE) || defined(MOXIE_NATIVE_BACKEND) || defined(_M_RTLD_NEXT) || defined(_M_IFUNC_DISPATCH) || defined(__darwin__)
+#error "moxie.hpp only supports the global MoxieState, the CppUMock integration, and ld --wrap interposition"
+#endif
+
+/*
+ * C++ Front-End:
+ * M_DECLARE_CXX_MOCK and M_IMPLEMENT_CXX_MOCK generate the same __wrap_##FUNC,
+ * __real_##FUNC, and API Function symbols as M_DECLARE_MOCK and
+ * M_IMPLEMENT_MOCK, and register the same MoxieState, such that the mocks of
+ * C++ translation units are controlled by the API Functions and the registry
+ * of C translation units alike.
+ *
+ * The prototype and the arguments are pasted verbatim rather than expanded
+ * per parameter; the parameters are recorded by variadic templates, and the
+ * default callFunc and stubFunc are dispatched statically.
+ *
+ * @note The parameters are recorded by type: bool, int (and the types that
+ * promote to int), unsigned int, long, unsigned long, double (and float),
+ * const char * (as a string), and any other pointer. The return type must be
+ * void, a pointer, an arithmetic type, or an enumeration.
+ * @note Moxie_capture(FUNC), Moxie_profile(FUNC), and M_VOID_EXIT are not
+ * available for the mocks of C++ translation units.
+ */
+
+/*
+ * API Macros:
+ */
+
+/**
+ * @brief Declares a mock for the specified function in a C++ translation
+ * unit.
+ *
+ * @example M_DECLARE_CXX_MOCK(double, pow, (double x, double y));
+ */
+#define M_DECLARE_CXX_MOCK(RET,FUNC,PROTO) \
+typedef ::moxie::Mock<RET PROTO> MoxieMock_##FUNC; \
+typedef MoxieMock_##FUNC::Return MoxieReturn_##FUNC; \
+typedef MoxieMock_##FUNC::CallFunc MoxieCallFunc_##FUNC; \
+typedef MoxieMock_##FUNC::StubFunc MoxieStubFunc_##FUNC; \
+typedef MoxieMock_##FUNC::RealFunc MoxieRealFunc_##FUNC; \
+extern "C" \
+{ \
+    RET __real_##FUNC PROTO; \
+    RET __wrap_##FUNC PROTO; \
+    void __mReset_##FUNC(void); \
+    void __mEnable_##FUNC(void); \
+    void __mSetScope_##FUNC(const char *); \
+    void __mSetCallFunc_##FUNC(MoxieCallFunc_##FUNC); \
+    void __mSetStubFunc_##FUNC(MoxieStubFunc_##FUNC); \
+    void __mSpy_##FUNC(void); \
+    unsigned long __mCallCount_##FUNC(void); \
+    unsigned long __mThreadCallCount_##FUNC(void); \
+    void __mSetReturnSequence_##FUNC(const MoxieReturn_##FUNC *, unsigned long, MoxieRepeat); \
+    void __mSetSampling_##FUNC(unsigned long, MoxieSampling); \
+    unsigned long __mSampleHits_##FUNC(void); \
+    unsigned long __mSampleSkips_##FUNC(void); \
+    void __mSetInjection_##FUNC(const MoxieInjection *, const MoxieReturn_##FUNC *); \
+}
+
+/**
+ * @brief Implements a mock for the specified function in a C++ translation
+ * unit.
+ *
+ * The parameter names of the CppUMock integration are those of the argument
+ * list, which must name the parameters of the prototype in order.
+ *
+ * @example M_IMPLEMENT_CXX_MOCK(double, pow, (double x, double y), (x, y));
+ */
+#define M_IMPLEMENT_CXX_MOCK(RET,FUNC,PROTO,ARGS) \
+static _M_ARMED_STORAGE int __mArmed_##FUNC = 0; \
+static ::moxie::Names<MoxieMock_##FUNC::arity, sizeof(#ARGS)> __mNames_##FUNC(#ARGS); \
+extern const MoxieMock_##FUNC::Descriptor __mDescriptor_##FUNC; \
+_Pragma("GCC diagnostic push") \
+_Pragma("GCC diagnostic ignored \"-Wmissing-field-initializers\"") \
+static MoxieState __mState_##FUNC = \
+{ \
+    0, \
+    (char *)"", \
+    (void *)&MoxieMock_##FUNC::defaultCallFunc<&__mDescriptor_##FUNC>, \
+    (void *)&MoxieMock_##FUNC::defaultStubFunc<&__mDescriptor_##FUNC>, \
+}; \
+_Pragma("GCC diagnostic pop") \
+const MoxieMock_##FUNC::Descriptor __mDescriptor_##FUNC = \
+{ \
+    &__mState_##FUNC, \
+    #FUNC, \
+    __mNames_##FUNC.names, \
+    &__mArmed_##FUNC, \
+    &__real_##FUNC, \
+}; \
+extern "C" RET __wrap_##FUNC PROTO \
+{ \
+    return MoxieMock_##FUNC::call<&__mDescriptor_##FUNC> ARGS; \
+} \
+extern "C" void __mReset_##FUNC(void) \
+{ \
+    MoxieMock_##FUNC::reset<&__mDescriptor_##FUNC>(); \
+} \
+extern "C" void __mEnable_##FUNC(void) \
+{ \
+    MoxieMock_##FUNC::arm<&__mDescriptor_##FUNC>(_M_FLAG_MOCK); \
+} \
+extern "C" void __mSetScope_##FUNC(const char *scope) \
+{ \
+    Assert(_M_STATE_LOAD_RELAXED(__mState_##FUNC.mockFlag) & _M_FLAG_MOCK); \
+    _M_STATE_STORE(__mState_##FUNC.scope, (char *)scope); \
+} \
+extern "C" void __mSetCallFunc_##FUNC(MoxieCallFunc_##FUNC callFunc) \
+{ \
+    Assert(_M_STATE_LOAD_RELAXED(__mState_##FUNC.mockFlag) & _M_FLAG_MOCK); \
+    _M_STATE_STORE(__mState_##FUNC.callFunc, (void *)callFunc); \
+} \
+extern "C" void __mSetStubFunc_##FUNC(MoxieStubFunc_##FUNC stubFunc) \
+{ \
+    Assert(_M_STATE_LOAD_RELAXED(__mState_##FUNC.mockFlag) & _M_FLAG_MOCK); \
+    _M_STATE_STORE(__mState_##FUNC.stubFunc, (void *)stubFunc); \
+} \
+extern "C" void __mSpy_##FUNC(void) \
+{ \
+    MoxieMock_##FUNC::arm<&__mDescriptor_##FUNC>(_M_FLAG_SPY); \
+} \
+extern "C" unsigned long __mCallCount_##FUNC(void) \
+{ \
+    return __atomic_load_n(&__mState_##FUNC.callCount, __ATOMIC_RELAXED); \
+} \
+extern "C" unsigned long __mThreadCallCount_##FUNC(void) \
+{ \
+    return MoxieMock_##FUNC::threadCallCount<&__mDescriptor_##FUNC>(); \
+} \
+extern "C" void __mSetReturnSequence_##FUNC(const MoxieReturn_##FUNC *values, unsigned long count, MoxieRepeat repeat) \
+{ \
+    MoxieMock_##FUNC::setReturnSequence<&__mDescriptor_##FUNC>(values, count, repeat); \
+} \
+extern "C" void __mSetSampling_##FUNC(unsigned long period, MoxieSampling mode) \
+{ \
+    MoxieMock_##FUNC::setSampling<&__mDescriptor_##FUNC>(period, mode); \
+} \
+extern "C" unsigned long __mSampleHits_##FUNC(void) \
+{ \
+    return __atomic_load_n(&__mState_##FUNC.sampleHits, __ATOMIC_RELAXED); \
+} \
+extern "C" unsigned long __mSampleSkips_##FUNC(void) \
+{ \
+    return MoxieMock_##FUNC::sampleSkips<&__mDescriptor_##FUNC>(); \
+} \
+extern "C" void __mSetInjection_##FUNC(const MoxieInjection *injection, const MoxieReturn_##FUNC *faultValue) \
+{ \
+    MoxieMock_##FUNC::setInjection<&__mDescriptor_##FUNC>(injection, faultValue); \
+} \
+static const MoxieRegistration __mRegistration_##FUNC \
+__attribute__((used,section(_M_REGISTRY_SECTION),aligned(sizeof(void *)))) = \
+{ \
+    #FUNC, \
+    &__mState_##FUNC, \
+    (void *)&MoxieMock_##FUNC::defaultCallFunc<&__mDescriptor_##FUNC>, \
+    (void *)&MoxieMock_##FUNC::defaultStubFunc<&__mDescriptor_##FUNC>, \
+    &__mReset_##FUNC, \
+    &__mEnable_##FUNC, \
+    NULL, \
+    0, \
+    &__mArmed_##FUNC, \
+    NULL, \
+    _M_KIND_NONE, \
+}
+
+/*
+ * Implementation:
+ */
+
+namespace moxie
+{
+
+/**
+ * @brief Records the specified parameter of an actual call.
+ */
+inline void withParameter(MockActualCall_c *actualCall, const char *name, bool value)
+{
+    actualCall->withBoolParameters(name, value);
+}
+
+inline void withParameter(MockActualCall_c *actualCall, const char *name, int value)
+{
+    actualCall->withIntParameters(name, value);
+}
+
+inline void withParameter(MockActualCall_c *actualCall, const char *name, unsigned int value)
+{
+    actualCall->withUnsignedIntParameters(name, value);
+}
+
+inline void withParameter(MockActualCall_c *actualCall, const char *name, long value)
+{
+    actualCall->withLongIntParameters(name, value);
+}
+
+inline void withParameter(MockActualCall_c *actualCall, const char *name, unsigned long value)
+{
+    actualCall->withUnsignedLongIntParameters(name, value);
+}
+
+inline void withParameter(MockActualCall_c *actualCall, const char *name, double value)
+{
+    actualCall->withDoubleParameters(name, value);
+}
+
+inline void withParameter(MockActualCall_c *actualCall, const char *name, const char *value)
+{
+    actualCall->withStringParameters(name, value);
+}
+
+template <typename T>
+inline void withParameter(MockActualCall_c *actualCall, const char *name, T *value)
+{
+    actualCall->withPointerParameters(name, (void *)value);
+}
+
+template <typename T>
+inline void withParameter(MockActualCall_c *actualCall, const char *name, const T *value)
+{
+    actualCall->withConstPointerParameters(name, (const void *)value);
+}
+
+/**
+ * @brief Returns the return value of an actual call as the specified type.
+ */
+template <typename R>
+struct ReturnValue
+{
+    static R get(MockActualCall_c *actualCall)
+    {
+        return (R)actualCall->intReturnValue();
+    }
+};
+
+template <>
+struct ReturnValue<void>
+{
+    static void get(MockActualCall_c *)
+    {
+    }
+};
+
+template <>
+struct ReturnValue<bool>
+{
+    static bool get(MockActualCall_c *actualCall)
+    {
+        return actualCall->boolReturnValue() != 0;
+    }
+};
+
+template <>
+struct ReturnValue<unsigned int>
+{
+    static unsigned int get(MockActualCall_c *actualCall)
+    {
+        return actualCall->unsignedIntReturnValue();
+    }
+};
+
+template <>
+struct ReturnValue<long>
+{
+    static long get(MockActualCall_c *actualCall)
+    {
+        return actualCall->longIntReturnValue();
+    }
+};
+
+template <>
+struct ReturnValue<unsigned long>
+{
+    static unsigned long get(MockActualCall_c *actualCall)
+    {
+        return actualCall->unsignedLongIntReturnValue();
+    }
+};
+
+template <>
+struct ReturnValue<float>
+{
+    static float get(MockActualCall_c *actualCall)
+    {
+        return (float)actualCall->doubleReturnValue();
+    }
+};
+
+template <>
+struct ReturnValue<double>
+{
+    static double get(MockActualCall_c *actualCall)
+    {
+        return actualCall->doubleReturnValue();
+    }
+};
+
+template <>
+struct ReturnValue<const char *>
+{
+    static const char *get(MockActualCall_c *actualCall)
+    {
+        return actualCall->stringReturnValue();
+    }
+};
+
+template <typename T>
+struct ReturnValue<T *>
+{
+    static T *get(MockActualCall_c *actualCall)
+    {
+        return (T *)actualCall->pointerReturnValue();
+    }
+};
+
+/**
+ * @brief Returns the specified value of an array of the specified type, as
+ * for a return sequence; an M_RETURN_VOID function returns nothing.
+ */
+template <typename R>
+struct Value
+{
+    static R at(const void *values, unsigned long index)
+    {
+        return ((const R *)values)[index];
+    }
+};
+
+template <>
+struct Value<void>
+{
+    static void at(const void *, unsigned long)
+    {
+    }
+};
+
+/**
+ * @brief Splits the stringized argument list of M_IMPLEMENT_CXX_MOCK, e.g.
+ * "(x, y)", into the parameter names of the CppUMock integration.
+ */
+template <unsigned long N, unsigned long L>
+struct Names
+{
+    char buffer[L];
+    const char *names[N ? N : 1];
+
+    explicit Names(const char *args)
+    {
+        unsigned long size = 0;
+        unsigned long count = 0;
+        for (; *args != '\0'; ++args)
+        {
+            if (*args == '(' || *args == ')' || *args == ' ' || *args == '\t' || *args == '\n')
+            {
+                continue;
+            }
+            if (*args == ',')
+            {
+                buffer[size++] = '\0';
+                continue;
+            }
+            if (size == 0 || buffer[size - 1] == '\0')
+            {
+                if (count < N)
+                {
+                    names[count] = &buffer[size];
+                }
+                ++count;
+            }
+            buffer[size++] = *args;
+        }
+        buffer[size] = '\0';
+        for (; count < N; ++count)
+        {
+            names[count] = "";
+        }
+    }
+};
+
+/**
+ * @brief A Mock implements the mocks of the functions of the specified
+ * signature.
+ */
+template <typename F>
+struct Mock;
+
+template <typename R, typename... A>
+struct Mock<R(A...)>
+{
+    typedef R Return;
+    typedef R (*RealFunc)(A...);
+    typedef void (*CallFunc)(MockSupport_c *, MockActualCall_c *, A...);
+    typedef R (*StubFunc)(MockSupport_c *, MockActualCall_c *, A...);
+
+    static const unsigned long arity = sizeof...(A);
+
+    /**
+     * @brief A Descriptor describes a mocked function of the signature.
+     */
+    struct Descriptor
+    {
+        MoxieState *state;
+        const char *name;
+        const char *const *names;
+        int *armed;
+        RealFunc realFunc;
+    };
+
+    template <const Descriptor *D>
+    static void defaultCallFunc(MockSupport_c *, MockActualCall_c *actualCall, A... args)
+    {
+        const char *const *name = D->names;
+        int expanded[] = { 0, (withParameter(actualCall, *name++, args), 0)... };
+        (void)expanded;
+        (void)actualCall;
+        (void)name;
+    }
+
+    template <const Descriptor *D>
+    static R defaultStubFunc(MockSupport_c *, MockActualCall_c *actualCall, A... args)
+    {
+        if (actualCall->hasReturnValue())
+        {
+            return ReturnValue<R>::get(actualCall);
+        }
+        return (*D->realFunc)(args...);
+    }
+
+    /**
+     * @brief The Fast Path of __wrap_##FUNC, which is always inlined such that
+     * the return address of _M_CALLER_SKIPPED() is the one of its caller.
+     */
+    template <const Descriptor *D>
+    static inline __attribute__((always_inline)) R call(A... args)
+    {
+        /* Fast Path: */
+        if (_M_LIKELY(!_M_STATE_LOAD_RELAXED(*D->armed)) || _M_CALLER_SKIPPED() || __mThreadInternal ||
+            (_M_UNLIKELY(sampler<D>()->countdown != 0) && __mSampleSkip(sampler<D>(), D->state)))
+        {
+            return (*D->realFunc)(args...);
+        }
+        /* Slow Path: */
+        return slowPath<D>(args...);
+    }
+
+    template <const Descriptor *D>
+    static _M_COLD R slowPath(A... args)
+    {
+        MoxieState *state = D->state;
+        int mockFlag = _M_STATE_LOAD(state->mockFlag);
+        unsigned long returnIndex;
+        if ((mockFlag & _M_FLAG_SAMPLE) && !__mSample(state, state, sampler<D>()))
+        {
+            return (*D->realFunc)(args...);
+        }
+        if (mockFlag & _M_FLAG_SPY)
+        {
+            count<D>();
+        }
+        if ((mockFlag & _M_FLAG_INJECT) && __mInject(_M_STATE_LOAD(state->injection), state))
+        {
+            return Value<R>::at(_M_STATE_LOAD(state->faultValue), 0);
+        }
+        if ((mockFlag & _M_FLAG_RETURN) && __mNextReturn(state, &returnIndex))
+        {
+            return Value<R>::at(_M_STATE_LOAD(state->returnValues), returnIndex);
+        }
+        if (!(mockFlag & _M_FLAG_MOCK))
+        {
+            return (*D->realFunc)(args...);
+        }
+        /* Process Call: */
+        _M_FLUSH_DEFERRED();
+        char *scope = _M_STATE_LOAD(state->scope);
+        MockSupport_c *mockSupport = (scope[0] == '\0') ? mock_c() : mock_scope_c(scope);
+        MockActualCall_c *actualCall = mockSupport->actualCall(D->name);
+        /* Defer to callFunc: */
+        CallFunc callFunc = (CallFunc)_M_STATE_LOAD(state->callFunc);
+        if (callFunc == &defaultCallFunc<D>)
+        {
+            defaultCallFunc<D>(mockSupport, actualCall, args...);
+        }
+        else if (callFunc != NULL)
+        {
+            (*callFunc)(mockSupport, actualCall, args...);
+        }
+        /* Defer to stubFunc: */
+        StubFunc stubFunc = (StubFunc)_M_STATE_LOAD(state->stubFunc);
+        if (stubFunc == &defaultStubFunc<D>)
+        {
+            return defaultStubFunc<D>(mockSupport, actualCall, args...);
+        }
+        else if (stubFunc != NULL)
+        {
+            return (*stubFunc)(mockSupport, actualCall, args...);
+        }
+        /* Defer to realFunc: */
+        return (*D->realFunc)(args...);
+    }
+
+    template <const Descriptor *D>
+    static MoxieCounter *threadCounter()
+    {
+        static __thread MoxieCounter counter = { 0, 0 };
+        return &counter;
+    }
+
+    template <const Descriptor *D>
+    static MoxieSampler *sampler()
+    {
+        static __thread MoxieSampler sampler = { NULL, 0, 0, 0 };
+        return &sampler;
+    }
+
+    template <const Descriptor *D>
+    static unsigned long sampleSkips()
+    {
+        return __atomic_load_n(&D->state->sampleSkips, __ATOMIC_RELAXED) + __mSamplePending(sampler<D>());
+    }
+
+    template <const Descriptor *D>
+    static void count()
+    {
+        MoxieCounter *counter = threadCounter<D>();
+        unsigned long epoch = __atomic_load_n(&D->state->callEpoch, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&D->state->callCount, 1, __ATOMIC_RELAXED);
+        if (counter->epoch != epoch)
+        {
+            counter->epoch = epoch;
+            counter->count = 0;
+        }
+        ++counter->count;
+    }
+
+    template <const Descriptor *D>
+    static unsigned long threadCallCount()
+    {
+        MoxieCounter *counter = threadCounter<D>();
+        unsigned long epoch = __atomic_load_n(&D->state->callEpoch, __ATOMIC_RELAXED);
+        return (counter->epoch == epoch) ? counter->count : 0;
+    }
+
+    template <const Descriptor *D>
+    static void arm(int flag)
+    {
+        _M_ARM(D->armed, D->state, _M_STATE_LOAD_RELAXED(D->state->mockFlag) | flag);
+    }
+
+    template <const Descriptor *D>
+    static void reset()
+    {
+        _M_ARM(D->armed, D->state, 0);
+        _M_STATE_RESET(D->state, &defaultCallFunc<D>, &defaultStubFunc<D>);
+        _M_STATE_RESET_COUNTERS(D->state);
+    }
+
+    template <const Descriptor *D>
+    static void setReturnSequence(const R *values, unsigned long count, MoxieRepeat repeat)
+    {
+        int mockFlag = _M_STATE_LOAD_RELAXED(D->state->mockFlag) & ~_M_FLAG_RETURN;
+        _M_ARM(D->armed, D->state, mockFlag);
+        _M_STATE_STORE(D->state->returnValues, (const void *)values);
+        _M_STATE_STORE(D->state->returnCount, count);
+        _M_STATE_STORE(D->state->returnCursor, 0);
+        _M_STATE_STORE(D->state->returnRepeat, repeat);
+        _M_ARM(D->armed, D->state, (count != 0) ? (mockFlag | _M_FLAG_RETURN) : mockFlag);
+    }
+
+    template <const Descriptor *D>
+    static void setSampling(unsigned long period, MoxieSampling mode)
+    {
+        int mockFlag = _M_STATE_LOAD_RELAXED(D->state->mockFlag) & ~_M_FLAG_SAMPLE;
+        _M_ARM(D->armed, D->state, mockFlag);
+        _M_STATE_STORE(D->state->samplePeriod, period);
+        _M_STATE_STORE(D->state->sampleMode, mode);
+        __atomic_add_fetch(&D->state->sampleEpoch, 1, __ATOMIC_RELAXED);
+        _M_ARM(D->armed, D->state, (period > 1) ? (mockFlag | _M_FLAG_SAMPLE) : mockFlag);
+    }
+
+    template <const Descriptor *D>
+    static void setInjection(const MoxieInjection *injection, const R *faultValue)
+    {
+        int mockFlag = _M_STATE_LOAD_RELAXED(D->state->mockFlag) & ~_M_FLAG_INJECT;
+        _M_ARM(D->armed, D->state, mockFlag);
+        _M_STATE_STORE(D->state->injection, injection);
+        _M_STATE_STORE(D->state->faultValue, (const void *)faultValue);
+        __atomic_store_n(&D->state->injectCursor, 0, __ATOMIC_RELAXED);
+        _M_ARM(D->armed, D->state, (injection != NULL) ? (mockFlag | _M_FLAG_INJECT) : mockFlag);
+    }
+};
+
+} // namespace moxie
+
+#endif // SRC_INCLUDE_MOXIE_HPP_
@@ -0,0 +1,69 @@
+#ifndef TEST_MOXIE_TEST_H_
+#define TEST_MOXIE_TEST_H_
+
+#include "moxie.h"
+
+#include <stdio.h>
+
+/*
+ * Assertions:
+ * The regression tests are plain C programs rather than CppUTest test groups,
+ * such that each one may pick its own configuration macros; a test reports
+ * each failed check and exits with whether any check failed. The calls that
+ * reach the actualCall() of CppUMock are checked against the expectations of
+ * mock_c() by TEST_CHECK_EXPECTATIONS(), as CppUMock itself fails the process
+ * upon a mismatched call outside of a test runner.
+ */
+
+#ifdef __cplusplus
+extern "C" int testFailures;
+#else
+extern int testFailures;
+#endif
+
+#define TEST_CHECK(COND) \
+do \
+{ \
+    if (!(COND)) \
+    { \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #COND); \
+        ++testFailures; \
+    } \
+} while (0)
+
+#define TEST_CHECK_EXPECTATIONS() \
+do \
+{ \
+    TEST_CHECK(mock_c()->expectedCallsLeft() == 0); \
+    mock_c()->clear(); \
+} while (0)
+
+#define TEST_RESULT() (testFailures != 0)
+
+/*
+ * Tested Functions:
+ * The realFuncs are defined in moxie_test_real.c such that the references of
+ * the tests are wrapped by `ld --wrap`.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+M_EXPORT_MOCK
+extern int test_add(int x, int y);
+
+M_EXPORT_MOCK
+extern int test_sub(int x, int y);
+
+M_EXPORT_MOCK
+extern int test_div(int x, int y, int *remainder);
+
+M_EXPORT_MOCK
+extern int test_sum(const unsigned char *bytes, unsigned long length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_MOXIE_TEST_H_
@@ -0,0 +1,40 @@
+#include "moxie_test.h"
+
+int testFailures = 0;
+
+/*
+ * Real Functions:
+ * The real functions are defined in their own translation unit such that the
+ * calls of the tests are not resolved before `ld --wrap`.
+ */
+
+int
+test_add(int x, int y)
+{
+    return x + y;
+}
+
+int
+test_sub(int x, int y)
+{
+    return x - y;
+}
+
+int
+test_div(int x, int y, int *remainder)
+{
+    *remainder = x % y;
+    return x / y;
+}
+
+int
+test_sum(const unsigned char *bytes, unsigned long length)
+{
+    int sum = 0;
+    unsigned long i;
+    for (i = 0; i < length; ++i)
+    {
+        sum += bytes[i];
+    }
+    return sum;
+}
@@ -0,0 +1,103 @@
+#!/bin/sh
+#
+# Builds and runs the Moxie regression tests (Linux).
+#
+# Every test/test_*.c is a program of its own, as each one may define the
+# configuration macros of moxie.h before including it. A test/test_*.cpp of the
+# same name is built into the same program, such that a test may mix the mocks
+# of moxie.h and moxie.hpp.
+#
+# Usage:
+#     CPPUTEST_HOME=/path/to/cpputest test/run_tests.sh [test_name ...]
+#
+# Environment:
+#     CPPUTEST_HOME    the CppUTest installation prefix (required)
+#     CPPUTEST_LIBDIR  the directory of libCppUTest.a and libCppUTestExt.a
+#                      (default: $CPPUTEST_HOME/lib)
+#     CC               the C compiler (default: cc)
+#     CXX              the C++ compiler (default: c++)
+#     CFLAGS           the C and C++ compiler flags (default: -O2)
+#     TEST_OUT         the directory of the test executables (default: test)
+
+set -e
+
+TEST_DIR=$(cd "$(dirname "$0")" && pwd)
+: "${CPPUTEST_HOME:?CPPUTEST_HOME must be set}"
+CPPUTEST_LIBDIR=${CPPUTEST_LIBDIR:-"$CPPUTEST_HOME/lib"}
+CC=${CC:-cc}
+CXX=${CXX:-c++}
+CFLAGS=${CFLAGS:--O2}
+TEST_OUT=${TEST_OUT:-"$TEST_DIR"}
+
+if [ $# -eq 0 ]; then
+    set -- $(cd "$TEST_DIR" && ls test_*.c | sed 's/\.c$//')
+fi
+
+# shellcheck disable=SC2086
+$CC -std=c99 $CFLAGS \
+    -I"$TEST_DIR/../include" \
+    -I"$CPPUTEST_HOME/include" \
+    -c -o "$TEST_OUT/moxie_test_real.o" \
+    "$TEST_DIR/moxie_test_real.c"
+
+# Builds the named test; `set -e` does not apply within a condition, such that
+# every step returns upon a failure.
+build_test() {
+    name=$1
+
+    # Every M_IMPLEMENT_MOCK of a test names its function on its own line, as
+    # does every entry of a mock table, from which the `ld --wrap`s are derived.
+    SOURCES="$TEST_DIR/$name.c"
+    if [ -f "$TEST_DIR/$name.cpp" ]; then
+        SOURCES="$SOURCES $TEST_DIR/$name.cpp"
+    fi
+    # shellcheck disable=SC2086
+    WRAPS=$(sed -n \
+        -e 's/^    \([a-z_][a-z0-9_]*\),$/-Wl,--wrap=\1/p' \
+        -e 's/^    X([^,]*, \([a-z_][a-z0-9_]*\),.*$/-Wl,--wrap=\1/p' \
+        $SOURCES | sort -u)
+    # A test of MOXIE_RTLD_NEXT interposes its functions without any wraps.
+    if grep -q '^#define MOXIE_RTLD_NEXT' "$TEST_DIR/$name.c"; then
+        WRAPS=
+    fi
+
+    # shellcheck disable=SC2086
+    $CC -std=c99 $CFLAGS \
+        -I"$TEST_DIR/../include" \
+        -I"$CPPUTEST_HOME/include" \
+        -c -o "$TEST_OUT/$name.o" \
+        "$TEST_DIR/$name.c" || return 1
+    OBJECTS="$TEST_OUT/$name.o"
+    if [ -f "$TEST_DIR/$name.cpp" ]; then
+        # shellcheck disable=SC2086
+        $CXX -std=c++11 $CFLAGS \
+            -I"$TEST_DIR/../include" \
+            -I"$CPPUTEST_HOME/include" \
+            -c -o "$TEST_OUT/$name.cpp.o" \
+            "$TEST_DIR/$name.cpp" || return 1
+        OBJECTS="$OBJECTS $TEST_OUT/$name.cpp.o"
+    fi
+
+    # shellcheck disable=SC2086
+    $CXX $CFLAGS \
+        -o "$TEST_OUT/$name" \
+        $OBJECTS \
+        "$TEST_OUT/moxie_test_real.o" \
+        $WRAPS \
+        -L"$CPPUTEST_LIBDIR" -lCppUTestExt -lCppUTest -lm -lpthread -ldl
+}
+
+failed=0
+for name in "$@"; do
+    if ! build_test "$name"; then
+        echo "FAIL $name (build)"
+        failed=1
+    elif "$TEST_OUT/$name"; then
+        echo "PASS $name"
+    else
+        echo "FAIL $name"
+        failed=1
+    fi
+done
+
+exit $failed
@@ -0,0 +1,73 @@
+/*
+ * MOXIE_ATOMIC_STATE:
+ * The API Functions of racing threads keep the armed counter of a mocked
+ * function consistent with its mockFlag, such that an enabled mock is never
+ * left on the Fast Path.
+ */
+
+#define MOXIE_ATOMIC_STATE
+
+#include "moxie_test.h"
+
+#include <pthread.h>
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+#define TEST_ROUNDS 100000
+
+static void *
+enabler(void *arg)
+{
+    int i;
+    (void)arg;
+    for (i = 0; i < TEST_ROUNDS; ++i)
+    {
+        Moxie_spy(test_add)();
+    }
+    return NULL;
+}
+
+static void *
+resetter(void *arg)
+{
+    int i;
+    (void)arg;
+    for (i = 0; i < TEST_ROUNDS; ++i)
+    {
+        Moxie_reset(test_add)();
+    }
+    return NULL;
+}
+
+int
+main(void)
+{
+    const MoxieRegistration *registration = Moxie_findByName("test_add");
+    pthread_t threads[2];
+    int round;
+
+    for (round = 0; round < 8; ++round)
+    {
+        pthread_create(&threads[0], NULL, &enabler, NULL);
+        pthread_create(&threads[1], NULL, &resetter, NULL);
+        pthread_join(threads[0], NULL);
+        pthread_join(threads[1], NULL);
+        TEST_CHECK(*registration->armed == (registration->state->mockFlag != 0));
+    }
+
+    Moxie_resetAll();
+    TEST_CHECK(*registration->armed == 0);
+    return TEST_RESULT();
+}
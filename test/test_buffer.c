@@ -0,0 +1,42 @@
+/*
+ * M_PARAM_BUFFER(PTYPE,PNAME,LEN_PARAM):
+ * The LEN_PARAM bytes of the buffer are reported to CppUMock as a memory
+ * buffer, such that an expectation matches the contents rather than the
+ * address of the buffer.
+ */
+
+#include "moxie_test.h"
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_sum,
+    M_PARAM_BUFFER(const unsigned char *,bytes,length),
+    M_PARAM_ULONG(unsigned long,length)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_sum,
+    M_PARAM_BUFFER(const unsigned char *,bytes,length),
+    M_PARAM_ULONG(unsigned long,length)
+);
+
+int
+main(void)
+{
+    static const unsigned char expected[] = { 1, 2, 3 };
+    unsigned char bytes[] = { 1, 2, 3, 4 };
+
+    TEST_CHECK(test_sum(bytes, 4) == 10);
+
+    Moxie_enable(test_sum)();
+    mock_c()->expectOneCall("test_sum")->withMemoryBufferParameter("bytes", expected, sizeof(expected))
+        ->withUnsignedLongIntParameters("length", 3)->andReturnIntValue(42);
+    mock_c()->expectOneCall("test_sum")->withMemoryBufferParameter("bytes", expected, 2)
+        ->withUnsignedLongIntParameters("length", 2);
+    TEST_CHECK(test_sum(bytes, 3) == 42);
+    TEST_CHECK(test_sum(bytes, 2) == 3);
+    TEST_CHECK_EXPECTATIONS();
+    Moxie_reset(test_sum)();
+    return TEST_RESULT();
+}
@@ -0,0 +1,60 @@
+/*
+ * MOXIE_CALLER_FILTER:
+ * The armed mocks of moxie.h and moxie.hpp (see test_caller_filter.cpp) only
+ * mock the calls made from the modules of Moxie_setCallerModules(), and send
+ * the calls of every other module to the realFunc.
+ */
+
+#define _GNU_SOURCE
+#define MOXIE_CALLER_FILTER
+
+#include "moxie_test.h"
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+/* Implemented by M_IMPLEMENT_CXX_MOCK in test_caller_filter.cpp. */
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_sub,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+int
+main(void)
+{
+    static const char *const others[] = { "libmoxie_test_missing" };
+    static const char *const executable[] = { "" };
+
+    Moxie_enable(test_add)();
+    Moxie_enable(test_sub)();
+
+    /* The calls of the executable are sent to the realFunc: */
+    TEST_CHECK(Moxie_setCallerModules(others, 1) == -1);
+    TEST_CHECK(test_add(1, 2) == 3);
+    TEST_CHECK(test_sub(3, 2) == 1);
+
+    /* The calls of the executable are mocked: */
+    TEST_CHECK(Moxie_setCallerModules(executable, 1) == 0);
+    mock_c()->expectOneCall("test_add")->withIntParameters("x", 1)->withIntParameters("y", 2)->andReturnIntValue(7);
+    mock_c()->expectOneCall("test_sub")->withIntParameters("x", 3)->withIntParameters("y", 2)->andReturnIntValue(8);
+    TEST_CHECK(test_add(1, 2) == 7);
+    TEST_CHECK(test_sub(3, 2) == 8);
+    TEST_CHECK_EXPECTATIONS();
+
+    Moxie_setCallerModules(NULL, 0);
+    Moxie_resetAll();
+    return TEST_RESULT();
+}
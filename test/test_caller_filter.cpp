@@ -0,0 +1,17 @@
+/*
+ * The C++ mock of test_caller_filter.c.
+ */
+
+#define MOXIE_CALLER_FILTER
+
+#include "moxie.hpp"
+#include "moxie_test.h"
+
+M_DECLARE_CXX_MOCK(int, test_sub, (int x, int y));
+
+M_IMPLEMENT_CXX_MOCK(
+    int,
+    test_sub,
+    (int x, int y),
+    (x, y)
+);
@@ -0,0 +1,61 @@
+/*
+ * Moxie_capture(FUNC)():
+ * The arguments of the most recent MOXIE_CAPTURE_CAPACITY calls are kept in
+ * the ring buffer of the function, whether or not the calls reach CppUMock.
+ */
+
+#define MOXIE_CAPTURE_CAPACITY 4
+
+#include "moxie_test.h"
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_div,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y),
+    M_PARAM_OUT_PTR(int *,remainder)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_div,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y),
+    M_PARAM_OUT_PTR(int *,remainder)
+);
+
+int
+main(void)
+{
+    const int three = 3;
+    int remainder = 0;
+    int i;
+
+    /* CppUMock fails upon any call of a capture: */
+    Moxie_capture(test_div)();
+    for (i = 0; i < 6; ++i)
+    {
+        TEST_CHECK(test_div(10 + i, 3, &remainder) == (10 + i) / 3);
+    }
+    TEST_CHECK(Moxie_capturedCount(test_div)() == 6);
+    TEST_CHECK(Moxie_captured(test_div)(0) != NULL && Moxie_captured(test_div)(0)->x == 15);
+    TEST_CHECK(Moxie_captured(test_div)(3) != NULL && Moxie_captured(test_div)(3)->x == 12);
+    TEST_CHECK(Moxie_captured(test_div)(3) != NULL && Moxie_captured(test_div)(3)->remainder == &remainder);
+    TEST_CHECK(Moxie_captured(test_div)(4) == NULL);
+
+    Moxie_enable(test_div)();
+    mock_c()->expectOneCall("test_div")->withIntParameters("x", 7)->withIntParameters("y", 2)
+        ->withOutputParameterReturning("remainder", &three, sizeof(three))->andReturnIntValue(1);
+    TEST_CHECK(test_div(7, 2, &remainder) == 1);
+    TEST_CHECK(remainder == 3);
+    TEST_CHECK_EXPECTATIONS();
+    TEST_CHECK(Moxie_capturedCount(test_div)() == 7);
+    TEST_CHECK(Moxie_captured(test_div)(0) != NULL && Moxie_captured(test_div)(0)->y == 2);
+
+    Moxie_reset(test_div)();
+    TEST_CHECK(Moxie_capturedCount(test_div)() == 0);
+    TEST_CHECK(Moxie_captured(test_div)(0) == NULL);
+    TEST_CHECK(test_div(9, 2, &remainder) == 4);
+    TEST_CHECK(Moxie_capturedCount(test_div)() == 0);
+    return TEST_RESULT();
+}
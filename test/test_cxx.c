@@ -0,0 +1,83 @@
+/*
+ * M_IMPLEMENT_CXX_MOCK:
+ * The mocks of a C++ translation unit (see test_cxx.cpp) record their
+ * parameters by type into CppUMock, and are controlled by the API Functions
+ * and the registry of a C translation unit.
+ */
+
+#include "moxie_test.h"
+
+/* Implemented by M_IMPLEMENT_CXX_MOCK in test_cxx.cpp. */
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_div,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y),
+    M_PARAM_OUT_PTR(int *,remainder)
+);
+
+/* Implemented by M_IMPLEMENT_CXX_MOCK in test_cxx.cpp. */
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_sum,
+    M_PARAM_IN_PTR(const unsigned char *,bytes),
+    M_PARAM_ULONG(unsigned long,length)
+);
+
+extern int test_cxx_stub_div(MockSupport_c *mockSupport, MockActualCall_c *actualCall, int x, int y, int *remainder);
+
+int
+main(void)
+{
+    static const unsigned char bytes[] = { 1, 2, 3 };
+    static const int sums[] = { 100 };
+    int remainder = 0;
+
+    TEST_CHECK(Moxie_findByName("test_div") != NULL);
+    TEST_CHECK(Moxie_findByName("test_sum") != NULL);
+
+    /* CppUMock fails upon any call of a spy: */
+    Moxie_spy(test_sum)();
+    TEST_CHECK(test_sum(bytes, 3) == 6);
+    TEST_CHECK(Moxie_callCount(test_sum)() == 1);
+
+    Moxie_enable(test_sum)();
+    mock_c()->expectOneCall("test_sum")->withConstPointerParameters("bytes", bytes)
+        ->withUnsignedLongIntParameters("length", 3ul)->andReturnIntValue(7);
+    mock_c()->expectOneCall("test_sum")->withConstPointerParameters("bytes", bytes)
+        ->withUnsignedLongIntParameters("length", 2ul);
+    TEST_CHECK(test_sum(bytes, 3) == 7);
+    TEST_CHECK(test_sum(bytes, 2) == 3);
+    TEST_CHECK_EXPECTATIONS();
+    TEST_CHECK(Moxie_callCount(test_sum)() == 3);
+
+    Moxie_setReturnSequence(test_sum)(sums, 1, MOXIE_REPEAT_NONE);
+    TEST_CHECK(test_sum(bytes, 3) == 100);
+    mock_c()->expectOneCall("test_sum")->withConstPointerParameters("bytes", bytes)
+        ->withUnsignedLongIntParameters("length", 1ul);
+    TEST_CHECK(test_sum(bytes, 1) == 1);
+    TEST_CHECK_EXPECTATIONS();
+
+    Moxie_enable(test_div)();
+    Moxie_setStubFunc(test_div)(&test_cxx_stub_div);
+    mock_c()->expectOneCall("test_div")->withIntParameters("x", 7)->withIntParameters("y", 2)
+        ->withPointerParameters("remainder", &remainder);
+    TEST_CHECK(test_div(7, 2, &remainder) == -3);
+    TEST_CHECK(remainder == 1);
+    TEST_CHECK_EXPECTATIONS();
+
+    /* The registry resets the mocks of C++ translation units as well: */
+    Moxie_resetAll();
+    TEST_CHECK(Moxie_callCount(test_sum)() == 0);
+    TEST_CHECK(test_sum(bytes, 3) == 6);
+    TEST_CHECK(test_div(7, 2, &remainder) == 3);
+
+    Moxie_enableAll();
+    mock_c()->expectOneCall("test_div")->withIntParameters("x", 9)->withIntParameters("y", 4)
+        ->withPointerParameters("remainder", &remainder);
+    TEST_CHECK(test_div(9, 4, &remainder) == 2);
+    TEST_CHECK(remainder == 1);
+    TEST_CHECK_EXPECTATIONS();
+    Moxie_resetAll();
+    return TEST_RESULT();
+}
@@ -0,0 +1,32 @@
+/*
+ * The C++ mocks of test_cxx.c, and a stubFunc of which the parameters are
+ * statically typed.
+ */
+
+#include "moxie.hpp"
+#include "moxie_test.h"
+
+M_DECLARE_CXX_MOCK(int, test_div, (int x, int y, int *remainder));
+
+M_IMPLEMENT_CXX_MOCK(
+    int,
+    test_div,
+    (int x, int y, int *remainder),
+    (x, y, remainder)
+);
+
+M_DECLARE_CXX_MOCK(int, test_sum, (const unsigned char *bytes, unsigned long length));
+
+M_IMPLEMENT_CXX_MOCK(
+    int,
+    test_sum,
+    (const unsigned char *bytes, unsigned long length),
+    (bytes, length)
+);
+
+extern "C" int
+test_cxx_stub_div(MockSupport_c *, MockActualCall_c *, int x, int y, int *remainder)
+{
+    *remainder = x % y;
+    return -(x / y);
+}
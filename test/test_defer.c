@@ -0,0 +1,94 @@
+/*
+ * Moxie_defer(FUNC)():
+ * The deferred calls reach CppUMock upon Moxie_checkExpectations(), also when
+ * they are answered by a return sequence, and before any later call that is
+ * processed at once, including the calls of a C++ mock (see test_defer.cpp).
+ */
+
+#define MOXIE_DEFER_CAPACITY 256
+
+#include "moxie_test.h"
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_div,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y),
+    M_PARAM_OUT_PTR(int *,remainder)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_div,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y),
+    M_PARAM_OUT_PTR(int *,remainder)
+);
+
+/* Implemented by M_IMPLEMENT_CXX_MOCK in test_defer.cpp. */
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_sub,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+int
+main(void)
+{
+    static const int sums[] = { 10 };
+    static const int quotients[] = { 4 };
+    const int one = 1;
+    int remainder = 0;
+
+    /* A return sequence answers the deferred calls, which are still logged: */
+    Moxie_defer(test_add)();
+    Moxie_setReturnSequence(test_add)(sums, 1, MOXIE_REPEAT_LAST);
+    mock_c()->expectOneCall("test_add")->withIntParameters("x", 1)->withIntParameters("y", 2);
+    mock_c()->expectOneCall("test_add")->withIntParameters("x", 3)->withIntParameters("y", 4);
+    TEST_CHECK(test_add(1, 2) == 10);
+    TEST_CHECK(test_add(3, 4) == 10);
+    TEST_CHECK(mock_c()->expectedCallsLeft() == 2);
+    Moxie_checkExpectations();
+    TEST_CHECK_EXPECTATIONS();
+    Moxie_resetAll();
+
+    /* A call that is processed at once follows the deferred calls before it: */
+    Moxie_defer(test_add)();
+    Moxie_enable(test_sub)();
+    mock_c()->strictOrder();
+    mock_c()->expectOneCall("test_add")->withIntParameters("x", 1)->withIntParameters("y", 2);
+    mock_c()->expectOneCall("test_sub")->withIntParameters("x", 5)->withIntParameters("y", 1)->andReturnIntValue(9);
+    TEST_CHECK(test_add(1, 2) == 3);
+    TEST_CHECK(test_sub(5, 1) == 9);
+    Moxie_checkExpectations();
+    TEST_CHECK_EXPECTATIONS();
+    Moxie_resetAll();
+
+    /* A call that cannot be deferred is processed at once, then answered by the
+     * return sequence: */
+    Moxie_defer(test_div)();
+    Moxie_setReturnSequence(test_div)(quotients, 1, MOXIE_REPEAT_LAST);
+    mock_c()->expectOneCall("test_div")->withIntParameters("x", 9)->withIntParameters("y", 2)
+        ->withOutputParameterReturning("remainder", &one, sizeof(one));
+    TEST_CHECK(test_div(9, 2, &remainder) == 4);
+    TEST_CHECK(remainder == 1);
+    TEST_CHECK_EXPECTATIONS();
+
+    Moxie_resetAll();
+    return TEST_RESULT();
+}
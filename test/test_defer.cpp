@@ -0,0 +1,17 @@
+/*
+ * The C++ mock of test_defer.c, of which the calls are processed at once.
+ */
+
+#define MOXIE_DEFER_CAPACITY 256
+
+#include "moxie.hpp"
+#include "moxie_test.h"
+
+M_DECLARE_CXX_MOCK(int, test_sub, (int x, int y));
+
+M_IMPLEMENT_CXX_MOCK(
+    int,
+    test_sub,
+    (int x, int y),
+    (x, y)
+);
@@ -0,0 +1,141 @@
+/*
+ * MOXIE_ENV_ENABLE:
+ * The constructor arms the entries of MOXIE_ENABLE, and reports and skips an
+ * entry with an unknown or unsupported MODE or a non-numeric `sample=` as a
+ * whole. The test re-executes itself with MOXIE_ENABLE, such that the
+ * constructor of the child parses it, and checks the stderr of the child.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define MOXIE_ENV_ENABLE
+
+#include "moxie_test.h"
+
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef MOXIE_TRACE_CAPACITY
+#define TEST_TRACE_ENTRY ""
+#else
+#define TEST_TRACE_ENTRY ",test_sub/trace"
+#endif
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_sub,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_sub,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_div,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y),
+    M_PARAM_OUT_PTR(int *,remainder)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_div,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y),
+    M_PARAM_OUT_PTR(int *,remainder)
+);
+
+static int
+child(void)
+{
+    int remainder = 0;
+
+    /* test_add/spy/sample=2 */
+    TEST_CHECK(test_add(1, 2) == 3);
+    TEST_CHECK(test_add(2, 2) == 4);
+    TEST_CHECK(test_add(3, 2) == 5);
+    TEST_CHECK(Moxie_callCount(test_add)() == 2);
+    TEST_CHECK(Moxie_sampleHits(test_add)() == 2);
+
+    /* test_sub: rather than test_sub:skipped/tick or test_sub/trace */
+    TEST_CHECK(strcmp(Moxie_findByName("test_sub")->state->scope, "") == 0);
+#ifndef MOXIE_NATIVE_BACKEND
+    mock_c()->expectOneCall("test_sub")->withIntParameters("x", 5)->withIntParameters("y", 1)->andReturnIntValue(9);
+    TEST_CHECK(test_sub(5, 1) == 9);
+    TEST_CHECK_EXPECTATIONS();
+#endif
+
+    /* test_div/spy/sample=abc */
+    TEST_CHECK(test_div(9, 2, &remainder) == 4);
+    TEST_CHECK(remainder == 1);
+    TEST_CHECK(Moxie_findByName("test_div")->state->mockFlag == 0);
+    return TEST_RESULT();
+}
+
+int
+main(void)
+{
+    static const char enable[] =
+        "test_add/spy/sample=2,test_sub:skipped/tick" TEST_TRACE_ENTRY ",test_sub,test_div/spy/sample=abc";
+    char output[4096];
+    size_t length = 0;
+    ssize_t size;
+    int fds[2];
+    int status;
+    pid_t pid;
+
+    if (getenv("MOXIE_ENABLE") != NULL)
+    {
+        return child();
+    }
+
+    TEST_CHECK(pipe(fds) == 0);
+    pid = fork();
+    if (pid == 0)
+    {
+        dup2(fds[1], STDERR_FILENO);
+        setenv("MOXIE_ENABLE", enable, 1);
+        execl("/proc/self/exe", "test_env_enable", (char *)NULL);
+        _exit(127);
+    }
+    close(fds[1]);
+    while ((size = read(fds[0], output + length, sizeof(output) - 1 - length)) > 0)
+    {
+        length += (size_t)size;
+    }
+    output[length] = '\0';
+    close(fds[0]);
+    TEST_CHECK(waitpid(pid, &status, 0) == pid);
+    TEST_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    TEST_CHECK(strstr(output, "entry 'test_sub:skipped': unknown mode 'tick'") != NULL);
+#ifndef MOXIE_TRACE_CAPACITY
+    TEST_CHECK(strstr(output, "entry 'test_sub': unsupported mode 'trace'") != NULL);
+#endif
+    TEST_CHECK(strstr(output, "entry 'test_div': non-numeric 'sample=abc'") != NULL);
+    if (TEST_RESULT())
+    {
+        fputs(output, stderr);
+    }
+    return TEST_RESULT();
+}
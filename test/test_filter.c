@@ -0,0 +1,66 @@
+/*
+ * Moxie_setFilter(FUNC)(filter):
+ * The enabled modes only process the calls whose arguments satisfy the filter,
+ * whereas the other calls are forwarded to the realFunc without reaching
+ * CppUMock or being counted, until the filter is cleared or reset.
+ */
+
+#include "moxie_test.h"
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+static int
+first_is_one(int x, int y)
+{
+    (void)y;
+    return x == 1;
+}
+
+int
+main(void)
+{
+    static const int sums[] = { 100 };
+
+    /* CppUMock fails upon any call that the filter rejects: */
+    Moxie_enable(test_add)();
+    Moxie_setFilter(test_add)(&first_is_one);
+    mock_c()->expectOneCall("test_add")->withIntParameters("x", 1)->withIntParameters("y", 2)->andReturnIntValue(0);
+    TEST_CHECK(test_add(2, 2) == 4);
+    TEST_CHECK(test_add(1, 2) == 0);
+    TEST_CHECK(test_add(3, 2) == 5);
+    TEST_CHECK_EXPECTATIONS();
+    Moxie_reset(test_add)();
+
+    Moxie_spy(test_add)();
+    Moxie_setFilter(test_add)(&first_is_one);
+    Moxie_setReturnSequence(test_add)(sums, 1, MOXIE_REPEAT_LAST);
+    TEST_CHECK(test_add(2, 2) == 4);
+    TEST_CHECK(test_add(1, 2) == 100);
+    TEST_CHECK(Moxie_callCount(test_add)() == 1);
+
+    Moxie_setFilter(test_add)(NULL);
+    TEST_CHECK(test_add(2, 2) == 100);
+    TEST_CHECK(Moxie_callCount(test_add)() == 2);
+
+    /* A reset clears the filter: */
+    Moxie_setFilter(test_add)(&first_is_one);
+    Moxie_reset(test_add)();
+    Moxie_enable(test_add)();
+    mock_c()->expectOneCall("test_add")->withIntParameters("x", 2)->withIntParameters("y", 2)->andReturnIntValue(0);
+    TEST_CHECK(test_add(2, 2) == 0);
+    TEST_CHECK_EXPECTATIONS();
+    Moxie_reset(test_add)();
+    return TEST_RESULT();
+}
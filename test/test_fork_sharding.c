@@ -0,0 +1,120 @@
+/*
+ * MOXIE_FORK_SHARDING:
+ * Every forked worker resets the counters of its parent but keeps their
+ * configuration, and suffixes its recording by the shard suffix of its fork,
+ * e.g. ".1" and ".1.1", such that the recordings of the workers are apart.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define MOXIE_FORK_SHARDING
+#define MOXIE_RECORD_REPLAY
+
+#include "moxie_test.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+static int
+join(pid_t pid)
+{
+    int status;
+    return pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static int
+worker(void)
+{
+    pid_t pid;
+    TEST_CHECK(strcmp(Moxie_shardSuffix(), ".1") == 0);
+    TEST_CHECK(Moxie_callCount(test_add)() == 0);
+    TEST_CHECK(test_add(20, 22) == 42);
+    TEST_CHECK(Moxie_callCount(test_add)() == 1);
+
+    Moxie_enable(test_add)();
+    mock_c()->expectOneCall("test_add")->withIntParameters("x", 3)->withIntParameters("y", 4)->andReturnIntValue(0);
+    TEST_CHECK(test_add(3, 4) == 0);
+    TEST_CHECK_EXPECTATIONS();
+
+    pid = fork();
+    if (pid == 0)
+    {
+        _exit(strcmp(Moxie_shardSuffix(), ".1.1") != 0);
+    }
+    TEST_CHECK(join(pid));
+    return TEST_RESULT();
+}
+
+int
+main(void)
+{
+    char path[] = "/tmp/moxie_test_shard.XXXXXX";
+    char shardPath[sizeof(path) + 8];
+    const char *suffixes[] = { ".1", ".1.1", ".2" };
+    pid_t pid;
+    int fd;
+    int i;
+
+    fd = mkstemp(path);
+    TEST_CHECK(fd >= 0);
+    close(fd);
+    TEST_CHECK(strcmp(Moxie_shardSuffix(), "") == 0);
+
+    /* CppUMock fails upon any call of a spy or a recording: */
+    Moxie_spy(test_add)();
+    Moxie_record(test_add)();
+    TEST_CHECK(Moxie_startRecording(path) == 0);
+    TEST_CHECK(test_add(1, 2) == 3);
+
+    pid = fork();
+    if (pid == 0)
+    {
+        _exit(worker());
+    }
+    TEST_CHECK(join(pid));
+    pid = fork();
+    if (pid == 0)
+    {
+        _exit(strcmp(Moxie_shardSuffix(), ".2") != 0);
+    }
+    TEST_CHECK(join(pid));
+    TEST_CHECK(Moxie_callCount(test_add)() == 1);
+    Moxie_stopRecording();
+    Moxie_reset(test_add)();
+
+    /* The recordings of the parent and of the first worker are apart: */
+    snprintf(shardPath, sizeof(shardPath), "%s.1", path);
+    TEST_CHECK(Moxie_startReplay(shardPath) == 0);
+    Moxie_replay(test_add)(MOXIE_REPLAY_ORDER);
+    TEST_CHECK(test_add(0, 0) == 42);
+    TEST_CHECK(test_add(0, 0) == 0);
+    TEST_CHECK(Moxie_startReplay(path) == 0);
+    TEST_CHECK(test_add(0, 0) == 3);
+    TEST_CHECK(test_add(0, 0) == 0);
+    Moxie_reset(test_add)();
+    Moxie_stopReplay();
+
+    unlink(path);
+    for (i = 0; i < 3; ++i)
+    {
+        snprintf(shardPath, sizeof(shardPath), "%s%s", path, suffixes[i]);
+        TEST_CHECK(access(shardPath, F_OK) == 0);
+        unlink(shardPath);
+    }
+    return TEST_RESULT();
+}
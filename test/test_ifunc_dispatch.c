@@ -0,0 +1,84 @@
+/*
+ * MOXIE_IFUNC_DISPATCH:
+ * The __wrap_ functions of a process that is not armed are bound to their
+ * realFuncs at load time, such that the API Functions have no effect on the
+ * calls, whereas the process of MOXIE_ARMED=1 mocks them as usual. The test
+ * re-executes itself with and without MOXIE_ARMED, as the resolvers read the
+ * environment upon startup.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define MOXIE_IFUNC_DISPATCH
+
+#include "moxie_test.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+static int
+child(int armed)
+{
+    Moxie_spy(test_add)();
+    TEST_CHECK(test_add(1, 2) == 3);
+    TEST_CHECK(Moxie_callCount(test_add)() == (armed ? 1ul : 0ul));
+
+    /* CppUMock fails upon any call of the process that is not armed: */
+    Moxie_enable(test_add)();
+    if (armed)
+    {
+        mock_c()->expectOneCall("test_add")->withIntParameters("x", 2)->withIntParameters("y", 2)->andReturnIntValue(5);
+    }
+    TEST_CHECK(test_add(2, 2) == (armed ? 5 : 4));
+    TEST_CHECK_EXPECTATIONS();
+    Moxie_reset(test_add)();
+    return TEST_RESULT();
+}
+
+static int
+spawn(char *const *env)
+{
+    int status;
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        execle("/proc/self/exe", "test_ifunc_dispatch", "child", (char *)NULL, env);
+        _exit(127);
+    }
+    return waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    static char armed[] = "MOXIE_ARMED=1";
+    static char disarmed[] = "MOXIE_ARMED=0";
+    char *armedEnv[] = { armed, NULL };
+    char *disarmedEnv[] = { disarmed, NULL };
+    char *emptyEnv[] = { NULL };
+
+    if (argc > 1 && strcmp(argv[1], "child") == 0)
+    {
+        const char *value = getenv("MOXIE_ARMED");
+        return child(value != NULL && strcmp(value, "0") != 0);
+    }
+    TEST_CHECK(spawn(armedEnv));
+    TEST_CHECK(spawn(disarmedEnv));
+    TEST_CHECK(spawn(emptyEnv));
+    return TEST_RESULT();
+}
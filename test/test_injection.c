@@ -0,0 +1,101 @@
+/*
+ * Moxie_setInjection(FUNC):
+ * The injected faults return the faultValue ahead of CppUMock, the draws of a
+ * seed are reproducible, and the injected latency delays the call by at least
+ * latencyNs.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "moxie_test.h"
+
+#include <time.h>
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+static unsigned long long
+now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+}
+
+int
+main(void)
+{
+    static const MoxieInjection always = {
+        .wait = MOXIE_WAIT_SPIN,
+        .faultProbability = 1.0,
+        .seed = 1,
+    };
+    static const MoxieInjection half = {
+        .wait = MOXIE_WAIT_SPIN,
+        .faultProbability = 0.5,
+        .seed = 42,
+    };
+    static const MoxieInjection slow = {
+        .wait = MOXIE_WAIT_SLEEP,
+        .latencyProbability = 1.0,
+        .latencyNs = 2000000,
+        .seed = 7,
+    };
+    static const int fault = -1;
+    int faults[2] = { 0, 0 };
+    int pattern = 0;
+    unsigned long long start;
+    int run;
+    int i;
+
+    /* CppUMock fails upon any faulted call that reaches it: */
+    Moxie_enable(test_add)();
+    Moxie_setInjection(test_add)(&always, &fault);
+    TEST_CHECK(test_add(1, 2) == -1);
+    TEST_CHECK(test_add(3, 4) == -1);
+
+    for (run = 0; run < 2; ++run)
+    {
+        Moxie_reset(test_add)();
+        Moxie_setInjection(test_add)(&half, &fault);
+        for (i = 0; i < 200; ++i)
+        {
+            int faulted = test_add(i, 0) == -1;
+            faults[run] += faulted;
+            if (i < 16 && run == 0)
+            {
+                pattern |= faulted << i;
+            }
+            else if (i < 16)
+            {
+                TEST_CHECK(((pattern >> i) & 1) == faulted);
+            }
+        }
+    }
+    TEST_CHECK(faults[0] == faults[1]);
+    TEST_CHECK(faults[0] > 60 && faults[0] < 140);
+
+    Moxie_setInjection(test_add)(&slow, &fault);
+    start = now();
+    TEST_CHECK(test_add(1, 2) == 3);
+    TEST_CHECK(now() - start >= 2000000ull);
+
+    Moxie_setInjection(test_add)(NULL, NULL);
+    Moxie_enable(test_add)();
+    mock_c()->expectOneCall("test_add")->withIntParameters("x", 1)->withIntParameters("y", 2)->andReturnIntValue(0);
+    TEST_CHECK(test_add(1, 2) == 0);
+    TEST_CHECK_EXPECTATIONS();
+    Moxie_reset(test_add)();
+    return TEST_RESULT();
+}
@@ -0,0 +1,63 @@
+/*
+ * Moxie_memoize(FUNC)():
+ * A hit only returns the cached return value, such that the functions whose
+ * outputs or pointers are not covered by the hash of the arguments must be
+ * refused rather than served stale results.
+ */
+
+#define MOXIE_MEMOIZE_CAPACITY 16
+
+#include "moxie_test.h"
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_div,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y),
+    M_PARAM_OUT_PTR(int *,remainder)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_div,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y),
+    M_PARAM_OUT_PTR(int *,remainder)
+);
+
+int
+main(void)
+{
+    int remainder;
+
+    Moxie_memoize(test_add)();
+    TEST_CHECK(test_add(1, 2) == 3);
+    TEST_CHECK(test_add(1, 2) == 3);
+    TEST_CHECK(Moxie_memoMisses(test_add)() == 1);
+    TEST_CHECK(Moxie_memoHits(test_add)() == 1);
+
+    Moxie_memoize(test_div)();
+    remainder = -1;
+    TEST_CHECK(test_div(7, 2, &remainder) == 3 && remainder == 1);
+    remainder = -1;
+    TEST_CHECK(test_div(7, 2, &remainder) == 3 && remainder == 1);
+    TEST_CHECK(Moxie_memoMisses(test_div)() == 0);
+    TEST_CHECK(Moxie_memoHits(test_div)() == 0);
+
+    Moxie_resetAll();
+    return TEST_RESULT();
+}
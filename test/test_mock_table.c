@@ -0,0 +1,38 @@
+/*
+ * M_IMPLEMENT_MOCK_TABLE:
+ * The entries of a mock table share one array of MoxieStates and one array of
+ * MoxieRegistrations, and are reset together by Moxie_resetTable(TABLE)().
+ */
+
+#include "moxie_test.h"
+
+#define TEST_MOCKS(X) \
+    X(M_RETURN_INT(int), test_add, M_PARAM_INT(int,x), M_PARAM_INT(int,y)) \
+    X(M_RETURN_INT(int), test_sub, M_PARAM_INT(int,x), M_PARAM_INT(int,y))
+
+M_DECLARE_MOCK_TABLE(TEST_MOCKS)
+M_IMPLEMENT_MOCK_TABLE(TEST_MOCKS)
+
+int
+main(void)
+{
+    const MoxieRegistration *add = Moxie_findByName("test_add");
+    const MoxieRegistration *sub = Moxie_findByName("test_sub");
+
+    TEST_CHECK(add != NULL && sub == add + 1);
+    TEST_CHECK(add != NULL && sub != NULL && sub->state == add->state + 1);
+
+    Moxie_spy(test_add)();
+    Moxie_spy(test_sub)();
+    TEST_CHECK(test_add(1, 2) == 3);
+    TEST_CHECK(test_sub(3, 2) == 1);
+    TEST_CHECK(test_sub(5, 2) == 3);
+    TEST_CHECK(Moxie_callCount(test_add)() == 1);
+    TEST_CHECK(Moxie_callCount(test_sub)() == 2);
+
+    Moxie_resetTable(TEST_MOCKS)();
+    TEST_CHECK(test_add(1, 2) == 3);
+    TEST_CHECK(Moxie_callCount(test_add)() == 0);
+    TEST_CHECK(Moxie_callCount(test_sub)() == 0);
+    return TEST_RESULT();
+}
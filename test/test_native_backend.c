@@ -0,0 +1,86 @@
+/*
+ * MOXIE_NATIVE_BACKEND:
+ * The expectations of Moxie_expect(FUNC) are matched in order without reaching
+ * CppUMock, and the unexpected calls and unmet expected calls are counted by
+ * Moxie_verify(FUNC) and Moxie_verifyAll().
+ */
+
+#define MOXIE_NATIVE_BACKEND
+#define MOXIE_NATIVE_CAPACITY 4
+
+#include "moxie_test.h"
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_sub,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_sub,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+int
+main(void)
+{
+    MoxieExpectation_test_add *expectation;
+    int i;
+
+    /* CppUMock fails upon any call that reaches it: */
+    Moxie_enable(test_add)();
+    expectation = Moxie_expect(test_add)(2);
+    expectation->args.x = 1;
+    expectation->args.y = 2;
+    expectation->returnValue = 9;
+    expectation->hasReturn = 1;
+    expectation = Moxie_expect(test_add)(1);
+    expectation->args.x = 5;
+    expectation->withMask &= ~(1ul << 1);
+    TEST_CHECK(Moxie_verify(test_add)() == 3);
+
+    TEST_CHECK(test_add(1, 2) == 9);
+    TEST_CHECK(test_add(1, 2) == 9);
+    TEST_CHECK(Moxie_verify(test_add)() == 1);
+    TEST_CHECK(test_add(5, 100) == 105);
+    TEST_CHECK(Moxie_verify(test_add)() == 0);
+    TEST_CHECK(Moxie_verifyAll() == 0);
+
+    /* An unexpected call is counted and deferred to the realFunc: */
+    TEST_CHECK(test_add(1, 2) == 3);
+    TEST_CHECK(Moxie_verify(test_add)() == 1);
+
+    Moxie_enable(test_sub)();
+    TEST_CHECK(Moxie_expect(test_sub)(1) != NULL);
+    TEST_CHECK(Moxie_verifyAll() == 2);
+    Moxie_resetAll();
+    TEST_CHECK(Moxie_verifyAll() == 0);
+
+    /* The arena holds MOXIE_NATIVE_CAPACITY expectations until a reset: */
+    for (i = 0; i < 4; ++i)
+    {
+        TEST_CHECK(Moxie_expect(test_add)(1) != NULL);
+    }
+    TEST_CHECK(Moxie_expect(test_add)(1) == NULL);
+    Moxie_reset(test_add)();
+    TEST_CHECK(Moxie_expect(test_add)(1) != NULL);
+    Moxie_reset(test_add)();
+    return TEST_RESULT();
+}
@@ -0,0 +1,88 @@
+/*
+ * Moxie_profile(FUNC)():
+ * The latencies of the realFunc are recorded into the histograms of every
+ * thread without reaching CppUMock, and their quantiles are upper bounds of
+ * the recorded latencies; the calls answered by a return sequence or by
+ * CppUMock are not recorded.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define MOXIE_PROFILE_SHARDS 4
+
+#include "moxie_test.h"
+
+#include <pthread.h>
+#include <time.h>
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    nanosleep,
+    M_PARAM_IGNORE(const struct timespec *,duration),
+    M_PARAM_OUT_PTR(struct timespec *,remaining)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    nanosleep,
+    M_PARAM_IGNORE(const struct timespec *,duration),
+    M_PARAM_OUT_PTR(struct timespec *,remaining)
+);
+
+static void
+sleep_ns(long ns)
+{
+    struct timespec duration = { 0, ns };
+    TEST_CHECK(nanosleep(&duration, NULL) == 0);
+}
+
+static void *
+worker(void *arg)
+{
+    int i;
+    (void)arg;
+    for (i = 0; i < 10; ++i)
+    {
+        sleep_ns(1000000);
+    }
+    return NULL;
+}
+
+int
+main(void)
+{
+    static const int results[] = { 0 };
+    pthread_t threads[3];
+    int i;
+
+    /* CppUMock fails upon any call of a profile: */
+    Moxie_profile(nanosleep)();
+    for (i = 0; i < 3; ++i)
+    {
+        pthread_create(&threads[i], NULL, &worker, NULL);
+    }
+    for (i = 0; i < 3; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    sleep_ns(20000000);
+    TEST_CHECK(Moxie_profileCount(nanosleep)() == 31);
+    TEST_CHECK(Moxie_profileQuantile(nanosleep)(0.5) >= 1000000ul);
+    TEST_CHECK(Moxie_profileQuantile(nanosleep)(0.5) < 20000000ul);
+    TEST_CHECK(Moxie_profileQuantile(nanosleep)(1.0) >= 20000000ul);
+
+    Moxie_setReturnSequence(nanosleep)(results, 1, MOXIE_REPEAT_LAST);
+    sleep_ns(1000000);
+    TEST_CHECK(Moxie_profileCount(nanosleep)() == 31);
+
+    Moxie_setReturnSequence(nanosleep)(NULL, 0, MOXIE_REPEAT_NONE);
+    Moxie_enable(nanosleep)();
+    mock_c()->expectOneCall("nanosleep")->ignoreOtherParameters()->andReturnIntValue(0);
+    sleep_ns(1000000);
+    TEST_CHECK_EXPECTATIONS();
+    TEST_CHECK(Moxie_profileCount(nanosleep)() == 31);
+
+    Moxie_reset(nanosleep)();
+    TEST_CHECK(Moxie_profileCount(nanosleep)() == 0);
+    TEST_CHECK(Moxie_profileQuantile(nanosleep)(0.5) == 0);
+    return TEST_RESULT();
+}
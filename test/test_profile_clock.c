@@ -0,0 +1,74 @@
+/*
+ * Moxie_profile(clock_gettime)():
+ * The timestamps of profiling and tracing, and the waits of the injected
+ * latencies, call clock_gettime() and nanosleep() from within the Slow Path,
+ * which must reach the realFuncs rather than recurse once they are mocked.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define MOXIE_PROFILE_SHARDS 4
+#define MOXIE_TRACE_CAPACITY 64
+
+#include "moxie_test.h"
+
+#include <time.h>
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    clock_gettime,
+    M_PARAM_INT(clockid_t,clockId),
+    M_PARAM_OUT_PTR(struct timespec *,tp)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    clock_gettime,
+    M_PARAM_INT(clockid_t,clockId),
+    M_PARAM_OUT_PTR(struct timespec *,tp)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    nanosleep,
+    M_PARAM_IGNORE(const struct timespec *,duration),
+    M_PARAM_OUT_PTR(struct timespec *,remaining)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    nanosleep,
+    M_PARAM_IGNORE(const struct timespec *,duration),
+    M_PARAM_OUT_PTR(struct timespec *,remaining)
+);
+
+int
+main(void)
+{
+    static const MoxieInjection spin = { .wait = MOXIE_WAIT_SPIN, .latencyProbability = 1.0, .latencyNs = 1000 };
+    static const MoxieInjection sleep = { .wait = MOXIE_WAIT_SLEEP, .latencyProbability = 1.0, .latencyNs = 1000 };
+    struct timespec now;
+    int i;
+
+    Moxie_spy(clock_gettime)();
+    Moxie_profile(clock_gettime)();
+    Moxie_trace(clock_gettime)();
+    for (i = 0; i < 3; ++i)
+    {
+        TEST_CHECK(clock_gettime(CLOCK_MONOTONIC, &now) == 0);
+    }
+    TEST_CHECK(Moxie_callCount(clock_gettime)() == 3);
+    TEST_CHECK(Moxie_profileCount(clock_gettime)() == 3);
+
+    Moxie_setInjection(clock_gettime)(&spin, NULL);
+    TEST_CHECK(clock_gettime(CLOCK_MONOTONIC, &now) == 0);
+    TEST_CHECK(Moxie_callCount(clock_gettime)() == 4);
+
+    Moxie_spy(nanosleep)();
+    Moxie_setInjection(clock_gettime)(&sleep, NULL);
+    TEST_CHECK(clock_gettime(CLOCK_MONOTONIC, &now) == 0);
+    TEST_CHECK(Moxie_callCount(clock_gettime)() == 5);
+    TEST_CHECK(Moxie_callCount(nanosleep)() == 0);
+
+    Moxie_resetAll();
+    return TEST_RESULT();
+}
@@ -0,0 +1,88 @@
+/*
+ * Moxie_record(FUNC)() and Moxie_replay(FUNC)(match):
+ * The results and output parameters of the realFunc are recorded to a file,
+ * except for the calls answered by CppUMock, and are served back from it by
+ * the order of the calls or by their arguments, whereas the calls without a
+ * MoxieRecord are deferred to the realFunc.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define MOXIE_RECORD_REPLAY
+
+#include "moxie_test.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_div,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y),
+    M_PARAM_OUT_PTR(int *,remainder)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_div,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y),
+    M_PARAM_OUT_PTR(int *,remainder)
+);
+
+int
+main(void)
+{
+    char path[] = "/tmp/moxie_test_record.XXXXXX";
+    int remainder = 0;
+    int fd;
+
+    fd = mkstemp(path);
+    TEST_CHECK(fd >= 0);
+    close(fd);
+    TEST_CHECK(Moxie_startReplay(path) == -1);
+
+    /* CppUMock fails upon any call of a recording: */
+    TEST_CHECK(Moxie_startRecording(path) == 0);
+    Moxie_record(test_div)();
+    TEST_CHECK(test_div(9, 2, &remainder) == 4);
+    TEST_CHECK(remainder == 1);
+
+    Moxie_enable(test_div)();
+    mock_c()->expectOneCall("test_div")->withIntParameters("x", 5)->withIntParameters("y", 5)
+        ->ignoreOtherParameters()->andReturnIntValue(0);
+    TEST_CHECK(test_div(5, 5, &remainder) == 0);
+    TEST_CHECK_EXPECTATIONS();
+
+    Moxie_reset(test_div)();
+    Moxie_record(test_div)();
+    TEST_CHECK(test_div(8, 3, &remainder) == 2);
+    TEST_CHECK(remainder == 2);
+    Moxie_stopRecording();
+    Moxie_reset(test_div)();
+
+    /* The recorded calls are replayed in order, whatever their arguments: */
+    TEST_CHECK(Moxie_startReplay(path) == 0);
+    Moxie_replay(test_div)(MOXIE_REPLAY_ORDER);
+    TEST_CHECK(test_div(100, 7, &remainder) == 4);
+    TEST_CHECK(remainder == 1);
+    TEST_CHECK(test_div(100, 7, &remainder) == 2);
+    TEST_CHECK(remainder == 2);
+    TEST_CHECK(test_div(100, 7, &remainder) == 14);
+    TEST_CHECK(remainder == 2);
+    Moxie_reset(test_div)();
+
+    TEST_CHECK(Moxie_startReplay(path) == 0);
+    Moxie_replay(test_div)(MOXIE_REPLAY_ARGUMENTS);
+    remainder = 0;
+    TEST_CHECK(test_div(8, 3, &remainder) == 2);
+    TEST_CHECK(remainder == 2);
+    TEST_CHECK(test_div(8, 3, &remainder) == 2);
+    TEST_CHECK(test_div(5, 5, &remainder) == 1);
+    TEST_CHECK(remainder == 0);
+    Moxie_reset(test_div)();
+    Moxie_stopReplay();
+
+    unlink(path);
+    return TEST_RESULT();
+}
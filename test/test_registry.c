@@ -0,0 +1,77 @@
+/*
+ * Registry:
+ * Every M_IMPLEMENT_MOCK registers its function, such that Moxie_findByName()
+ * finds it, and Moxie_enableAll() and Moxie_resetAll() enable and reset every
+ * mocked function at once.
+ */
+
+#include "moxie_test.h"
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_sub,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_sub,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+int
+main(void)
+{
+    const MoxieRegistration *add = Moxie_findByName("test_add");
+    const MoxieRegistration *sub = Moxie_findByName("test_sub");
+
+    TEST_CHECK(add != NULL && strcmp(add->name, "test_add") == 0);
+    TEST_CHECK(sub != NULL && strcmp(sub->name, "test_sub") == 0);
+    TEST_CHECK(Moxie_findByName("test_div") == NULL);
+    TEST_CHECK(_M_REGISTRY_END - _M_REGISTRY_BEGIN == 2);
+
+    Moxie_enableAll();
+    Moxie_setScope(test_sub)("MATH");
+    mock_c()->expectOneCall("test_add")->withIntParameters("x", 1)->withIntParameters("y", 2)->andReturnIntValue(0);
+    mock_scope_c("MATH")->expectOneCall("test_sub")->withIntParameters("x", 3)->withIntParameters("y", 2)->andReturnIntValue(0);
+    TEST_CHECK(test_add(1, 2) == 0);
+    TEST_CHECK(test_sub(3, 2) == 0);
+    TEST_CHECK_EXPECTATIONS();
+
+    Moxie_spy(test_add)();
+    mock_c()->expectOneCall("test_add")->withIntParameters("x", 1)->withIntParameters("y", 1)->andReturnIntValue(0);
+    TEST_CHECK(test_add(1, 1) == 0);
+    TEST_CHECK_EXPECTATIONS();
+    TEST_CHECK(Moxie_callCount(test_add)() == 1);
+
+    /* CppUMock fails upon any call of a reset mock: */
+    Moxie_resetAll();
+    TEST_CHECK(Moxie_callCount(test_add)() == 0);
+    TEST_CHECK(test_add(1, 2) == 3);
+    TEST_CHECK(test_sub(3, 2) == 1);
+    TEST_CHECK(strcmp(sub->state->scope, "") == 0);
+
+    (*add->enable)();
+    mock_c()->expectOneCall("test_add")->withIntParameters("x", 2)->withIntParameters("y", 2)->andReturnIntValue(5);
+    TEST_CHECK(test_add(2, 2) == 5);
+    TEST_CHECK_EXPECTATIONS();
+    (*add->reset)();
+    TEST_CHECK(test_add(2, 2) == 4);
+    return TEST_RESULT();
+}
@@ -0,0 +1,62 @@
+/*
+ * Moxie_setReturnSequence(FUNC):
+ * The values of the sequence are returned without reaching CppUMock; once the
+ * sequence is exhausted, the calls either reach CppUMock (or the realFunc) or
+ * repeat the sequence as described by its MoxieRepeat.
+ */
+
+#include "moxie_test.h"
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+int
+main(void)
+{
+    static const int values[] = { 10, 20, 30 };
+
+    /* MOXIE_REPEAT_NONE defers to CppUMock: */
+    Moxie_enable(test_add)();
+    Moxie_setReturnSequence(test_add)(values, 2, MOXIE_REPEAT_NONE);
+    mock_c()->expectOneCall("test_add")->withIntParameters("x", 1)->withIntParameters("y", 2)->andReturnIntValue(7);
+    TEST_CHECK(test_add(1, 2) == 10);
+    TEST_CHECK(test_add(1, 2) == 20);
+    TEST_CHECK(mock_c()->expectedCallsLeft() == 1);
+    TEST_CHECK(test_add(1, 2) == 7);
+    TEST_CHECK_EXPECTATIONS();
+    Moxie_reset(test_add)();
+
+    /* MOXIE_REPEAT_NONE defers to the realFunc unless the mock is enabled: */
+    Moxie_setReturnSequence(test_add)(values, 1, MOXIE_REPEAT_NONE);
+    TEST_CHECK(test_add(1, 2) == 10);
+    TEST_CHECK(test_add(1, 2) == 3);
+    Moxie_reset(test_add)();
+
+    Moxie_setReturnSequence(test_add)(values, 2, MOXIE_REPEAT_LAST);
+    TEST_CHECK(test_add(1, 2) == 10);
+    TEST_CHECK(test_add(1, 2) == 20);
+    TEST_CHECK(test_add(1, 2) == 20);
+
+    Moxie_setReturnSequence(test_add)(values, 3, MOXIE_REPEAT_CYCLE);
+    TEST_CHECK(test_add(1, 2) == 10);
+    TEST_CHECK(test_add(1, 2) == 20);
+    TEST_CHECK(test_add(1, 2) == 30);
+    TEST_CHECK(test_add(1, 2) == 10);
+
+    /* A count of 0 clears the sequence: */
+    Moxie_setReturnSequence(test_add)(values, 0, MOXIE_REPEAT_CYCLE);
+    TEST_CHECK(test_add(1, 2) == 3);
+    TEST_CHECK(Moxie_findByName("test_add")->state->mockFlag == 0);
+    return TEST_RESULT();
+}
@@ -0,0 +1,50 @@
+/*
+ * MOXIE_RTLD_NEXT:
+ * M_IMPLEMENT_MOCK defines getpid() itself, such that the test is linked
+ * without any `ld --wrap`s (see run_tests.sh), and its realFunc is the getpid()
+ * of libc that follows it in the lookup order.
+ */
+
+#define _GNU_SOURCE
+#define MOXIE_RTLD_NEXT
+
+#include "moxie_test.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(pid_t),
+    getpid,
+    M_PARAM_VOID
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(pid_t),
+    getpid,
+    M_PARAM_VOID
+);
+
+int
+main(void)
+{
+    static const pid_t pids[] = { 42 };
+    pid_t pid = (pid_t)syscall(SYS_getpid);
+
+    TEST_CHECK(getpid() == pid);
+    TEST_CHECK(M_REAL_FUNC(getpid)() == pid);
+    TEST_CHECK(Moxie_findByName("getpid")->state->realFunc != NULL);
+
+    Moxie_setReturnSequence(getpid)(pids, 1, MOXIE_REPEAT_NONE);
+    TEST_CHECK(getpid() == 42);
+    TEST_CHECK(getpid() == pid);
+
+    Moxie_enable(getpid)();
+    mock_c()->expectOneCall("getpid")->andReturnIntValue(7);
+    mock_c()->expectOneCall("getpid");
+    TEST_CHECK(getpid() == 7);
+    TEST_CHECK(getpid() == pid);
+    TEST_CHECK_EXPECTATIONS();
+    Moxie_reset(getpid)();
+    return TEST_RESULT();
+}
@@ -0,0 +1,107 @@
+/*
+ * Moxie_setSampling(FUNC):
+ * The unsampled calls of each thread are counted down on the Fast Path and
+ * published by its next sampled call, such that Moxie_sampleHits(FUNC) and
+ * Moxie_sampleSkips(FUNC) add up to the calls; only the sampled calls of the
+ * C++ mock (see test_sampling.cpp) reach CppUMock.
+ */
+
+#include "moxie_test.h"
+
+#include <pthread.h>
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+/* Implemented by M_IMPLEMENT_CXX_MOCK in test_sampling.cpp. */
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_sub,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+static void *
+worker(void *arg)
+{
+    int i;
+    (void)arg;
+    for (i = 0; i < 9; ++i)
+    {
+        TEST_CHECK(test_add(i, 1) == i + 1);
+    }
+    return NULL;
+}
+
+int
+main(void)
+{
+    pthread_t thread;
+    int i;
+
+    /* Samples the 1st, 5th, and 9th call. */
+    Moxie_spy(test_add)();
+    Moxie_setSampling(test_add)(4, MOXIE_SAMPLE_PERIODIC);
+    for (i = 0; i < 10; ++i)
+    {
+        TEST_CHECK(test_add(i, 2) == i + 2);
+    }
+    TEST_CHECK(Moxie_callCount(test_add)() == 3);
+    TEST_CHECK(Moxie_sampleHits(test_add)() == 3);
+    TEST_CHECK(Moxie_sampleSkips(test_add)() == 7);
+
+    /* Counts down the calls of the worker on its own. */
+    pthread_create(&thread, NULL, &worker, NULL);
+    pthread_join(thread, NULL);
+    TEST_CHECK(Moxie_callCount(test_add)() == 6);
+    TEST_CHECK(Moxie_sampleHits(test_add)() == 6);
+    TEST_CHECK(Moxie_sampleSkips(test_add)() == 13);
+
+    /* Restarts the countdown upon a reset. */
+    Moxie_reset(test_add)();
+    TEST_CHECK(Moxie_sampleSkips(test_add)() == 0);
+    Moxie_spy(test_add)();
+    Moxie_setSampling(test_add)(4, MOXIE_SAMPLE_PERIODIC);
+    TEST_CHECK(test_add(1, 1) == 2);
+    TEST_CHECK(Moxie_sampleHits(test_add)() == 1);
+    TEST_CHECK(Moxie_sampleSkips(test_add)() == 0);
+
+    /* Samples about half of the calls. */
+    Moxie_reset(test_add)();
+    Moxie_spy(test_add)();
+    Moxie_setSampling(test_add)(2, MOXIE_SAMPLE_RANDOM);
+    for (i = 0; i < 1000; ++i)
+    {
+        TEST_CHECK(test_add(i, 3) == i + 3);
+    }
+    TEST_CHECK(Moxie_sampleHits(test_add)() + Moxie_sampleSkips(test_add)() == 1000);
+    TEST_CHECK(Moxie_callCount(test_add)() == Moxie_sampleHits(test_add)());
+    TEST_CHECK(Moxie_sampleHits(test_add)() > 350 && Moxie_sampleHits(test_add)() < 650);
+    Moxie_reset(test_add)();
+
+    /* Mocks the 1st and 4th call. */
+    Moxie_enable(test_sub)();
+    Moxie_setSampling(test_sub)(3, MOXIE_SAMPLE_PERIODIC);
+    mock_c()->expectOneCall("test_sub")->withIntParameters("x", 0)->withIntParameters("y", 1)->andReturnIntValue(42);
+    mock_c()->expectOneCall("test_sub")->withIntParameters("x", 3)->withIntParameters("y", 1)->andReturnIntValue(42);
+    for (i = 0; i < 6; ++i)
+    {
+        TEST_CHECK(test_sub(i, 1) == ((i % 3 == 0) ? 42 : i - 1));
+    }
+    TEST_CHECK_EXPECTATIONS();
+    TEST_CHECK(Moxie_sampleHits(test_sub)() == 2);
+    TEST_CHECK(Moxie_sampleSkips(test_sub)() == 4);
+    Moxie_reset(test_sub)();
+    return TEST_RESULT();
+}
@@ -0,0 +1,15 @@
+/*
+ * The C++ mock of test_sampling.c.
+ */
+
+#include "moxie.hpp"
+#include "moxie_test.h"
+
+M_DECLARE_CXX_MOCK(int, test_sub, (int x, int y));
+
+M_IMPLEMENT_CXX_MOCK(
+    int,
+    test_sub,
+    (int x, int y),
+    (x, y)
+);
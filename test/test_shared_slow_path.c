@@ -0,0 +1,65 @@
+/*
+ * MOXIE_SHARED_SLOW_PATH:
+ * The shared Slow Path records the parameters of the descriptor into CppUMock
+ * as the Slow Path of every mocked function does, and runs the code of an
+ * M_PARAM_CUSTOM in any position of the parameters.
+ */
+
+#define MOXIE_SHARED_SLOW_PATH
+
+#include "moxie_test.h"
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_CUSTOM(int,y,actualCall->withIntParameters("y", y % 10);)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_CUSTOM(int,y,actualCall->withIntParameters("y", y % 10);)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_div,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y),
+    M_PARAM_OUT_PTR(int *,remainder)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_div,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y),
+    M_PARAM_OUT_PTR(int *,remainder)
+);
+
+int
+main(void)
+{
+    const int one = 1;
+    int remainder = 0;
+
+    Moxie_enable(test_add)();
+    mock_c()->expectOneCall("test_add")->withIntParameters("x", 1)->withIntParameters("y", 3)->andReturnIntValue(0);
+    mock_c()->expectOneCall("test_add")->withIntParameters("x", 2)->withIntParameters("y", 5);
+    TEST_CHECK(test_add(1, 13) == 0);
+    TEST_CHECK(test_add(2, 25) == 27);
+    TEST_CHECK_EXPECTATIONS();
+
+    Moxie_enable(test_div)();
+    mock_c()->expectOneCall("test_div")->withIntParameters("x", 9)->withIntParameters("y", 2)
+        ->withOutputParameterReturning("remainder", &one, sizeof(one))->andReturnIntValue(4);
+    TEST_CHECK(test_div(9, 2, &remainder) == 4);
+    TEST_CHECK(remainder == 1);
+    TEST_CHECK_EXPECTATIONS();
+
+    Moxie_resetAll();
+    TEST_CHECK(test_add(1, 13) == 14);
+    return TEST_RESULT();
+}
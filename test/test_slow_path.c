@@ -0,0 +1,69 @@
+/*
+ * Fast Path and Slow Path:
+ * A disabled mock forwards every call to the realFunc without reaching
+ * CppUMock, whereas an enabled mock reports every call to the actualCall() of
+ * its scope, and returns the value of the expectation, of the stubFunc, or of
+ * the realFunc.
+ */
+
+#include "moxie_test.h"
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+static int
+stub_add(MockSupport_c *mockSupport, MockActualCall_c *actualCall, int x, int y)
+{
+    (void)mockSupport;
+    (void)actualCall;
+    return x * y;
+}
+
+static void
+call_add(MockSupport_c *mockSupport, MockActualCall_c *actualCall, int x, int y)
+{
+    (void)mockSupport;
+    (void)y;
+    actualCall->withIntParameters("x", x);
+}
+
+int
+main(void)
+{
+    /* CppUMock fails upon any call of a disabled mock: */
+    TEST_CHECK(test_add(1, 2) == 3);
+    TEST_CHECK(M_REAL_FUNC(test_add)(2, 2) == 4);
+
+    Moxie_enable(test_add)();
+    mock_c()->expectOneCall("test_add")->withIntParameters("x", 1)->withIntParameters("y", 2)->andReturnIntValue(7);
+    mock_c()->expectOneCall("test_add")->withIntParameters("x", 3)->withIntParameters("y", 4);
+    TEST_CHECK(test_add(1, 2) == 7);
+    TEST_CHECK(test_add(3, 4) == 7);
+    TEST_CHECK_EXPECTATIONS();
+
+    Moxie_setScope(test_add)("MATH");
+    mock_scope_c("MATH")->expectOneCall("test_add")->withIntParameters("x", 2)->withIntParameters("y", 5);
+    Moxie_setStubFunc(test_add)(stub_add);
+    TEST_CHECK(test_add(2, 5) == 10);
+    TEST_CHECK_EXPECTATIONS();
+
+    Moxie_setCallFunc(test_add)(call_add);
+    mock_scope_c("MATH")->expectOneCall("test_add")->withIntParameters("x", 3);
+    TEST_CHECK(test_add(3, 3) == 9);
+    TEST_CHECK_EXPECTATIONS();
+
+    Moxie_reset(test_add)();
+    TEST_CHECK(test_add(4, 5) == 9);
+    return TEST_RESULT();
+}
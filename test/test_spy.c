@@ -0,0 +1,75 @@
+/*
+ * Moxie_spy(FUNC)():
+ * A spy counts the calls of every thread and forwards them to the realFunc
+ * without reaching CppUMock, unless the CppUMock integration is enabled as
+ * well.
+ */
+
+#include "moxie_test.h"
+
+#include <pthread.h>
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+static void *
+worker(void *arg)
+{
+    int i;
+    (void)arg;
+    for (i = 0; i < 100; ++i)
+    {
+        TEST_CHECK(test_add(i, 1) == i + 1);
+    }
+    TEST_CHECK(Moxie_threadCallCount(test_add)() == 100);
+    return NULL;
+}
+
+int
+main(void)
+{
+    pthread_t threads[4];
+    int i;
+
+    /* CppUMock fails upon any call of a spy: */
+    Moxie_spy(test_add)();
+    TEST_CHECK(test_add(1, 2) == 3);
+    TEST_CHECK(test_add(2, 2) == 4);
+    TEST_CHECK(Moxie_callCount(test_add)() == 2);
+    TEST_CHECK(Moxie_threadCallCount(test_add)() == 2);
+
+    for (i = 0; i < 4; ++i)
+    {
+        pthread_create(&threads[i], NULL, &worker, NULL);
+    }
+    for (i = 0; i < 4; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    TEST_CHECK(Moxie_callCount(test_add)() == 402);
+    TEST_CHECK(Moxie_threadCallCount(test_add)() == 2);
+
+    Moxie_enable(test_add)();
+    mock_c()->expectOneCall("test_add")->withIntParameters("x", 3)->withIntParameters("y", 4)->andReturnIntValue(0);
+    TEST_CHECK(test_add(3, 4) == 0);
+    TEST_CHECK_EXPECTATIONS();
+    TEST_CHECK(Moxie_callCount(test_add)() == 403);
+
+    Moxie_reset(test_add)();
+    TEST_CHECK(Moxie_callCount(test_add)() == 0);
+    TEST_CHECK(Moxie_threadCallCount(test_add)() == 0);
+    TEST_CHECK(test_add(1, 1) == 2);
+    TEST_CHECK(Moxie_callCount(test_add)() == 0);
+    return TEST_RESULT();
+}
@@ -0,0 +1,116 @@
+/*
+ * Moxie_exportStats(name):
+ * The stats segment holds one record per mocked function of the registry,
+ * which an external reader maps by its name, and whose statistics are only
+ * refreshed by Moxie_updateStats().
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define MOXIE_STATS_EXPORT
+
+#include "moxie_test.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_sub,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_sub,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+static const MoxieStatsRecord *
+find(const MoxieStatsHeader *stats, const char *name)
+{
+    const MoxieStatsRecord *record = (const MoxieStatsRecord *)(stats + 1);
+    uint64_t i;
+    for (i = 0; i < stats->recordCount; ++i, ++record)
+    {
+        if (strcmp(record->name, name) == 0)
+        {
+            return record;
+        }
+    }
+    return NULL;
+}
+
+int
+main(void)
+{
+    static const char name[] = "/moxie.test_stats_export";
+    MoxieStatsHeader *stats;
+    const MoxieStatsHeader *reader;
+    const MoxieStatsRecord *record;
+    size_t size;
+    int fd;
+
+    stats = Moxie_exportStats(name);
+    TEST_CHECK(stats != NULL);
+    TEST_CHECK(stats->magic == MOXIE_STATS_MAGIC);
+    TEST_CHECK(stats->version == MOXIE_STATS_VERSION);
+    TEST_CHECK(stats->recordCount == 2);
+    size = sizeof(MoxieStatsHeader) + (size_t)stats->recordCount * sizeof(MoxieStatsRecord);
+
+    fd = shm_open(name, O_RDONLY, 0);
+    TEST_CHECK(fd >= 0);
+    reader = (const MoxieStatsHeader *)mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    TEST_CHECK(reader != MAP_FAILED);
+    record = find(reader, "test_add");
+    TEST_CHECK(record != NULL);
+    TEST_CHECK(find(reader, "test_sub") != NULL);
+    TEST_CHECK(record->callCount == 0);
+    TEST_CHECK(record->sequence % 2 == 0);
+
+    /* CppUMock fails upon any call of a spy: */
+    Moxie_spy(test_add)();
+    TEST_CHECK(test_add(1, 2) == 3);
+    TEST_CHECK(test_add(2, 2) == 4);
+    TEST_CHECK(record->callCount == 0);
+    Moxie_updateStats(stats);
+    TEST_CHECK(reader->generation == 2);
+    TEST_CHECK(record->callCount == 2);
+    TEST_CHECK(record->mockFlag != 0);
+
+    Moxie_enable(test_add)();
+    mock_c()->expectOneCall("test_add")->withIntParameters("x", 3)->withIntParameters("y", 4)->andReturnIntValue(0);
+    TEST_CHECK(test_add(3, 4) == 0);
+    TEST_CHECK_EXPECTATIONS();
+    Moxie_updateStats(stats);
+    TEST_CHECK(record->callCount == 3);
+    TEST_CHECK(record->sequence % 2 == 0);
+
+    Moxie_reset(test_add)();
+    Moxie_updateStats(stats);
+    TEST_CHECK(record->callCount == 0);
+    TEST_CHECK(record->mockFlag == 0);
+
+    munmap((void *)reader, size);
+    Moxie_unexportStats(stats, name);
+    TEST_CHECK(shm_open(name, O_RDONLY, 0) < 0);
+    return TEST_RESULT();
+}
@@ -0,0 +1,80 @@
+/*
+ * Moxie_reset(FUNC)() of MOXIE_THREAD_LOCAL_STATE:
+ * A thread that resets its configuration must not reset the counters that are
+ * shared by every thread, and a thread that exits without a reset must not
+ * leave its configuration armed.
+ */
+
+#define MOXIE_THREAD_LOCAL_STATE
+
+#include "moxie_test.h"
+
+#include <pthread.h>
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+static void *
+worker(void *arg)
+{
+    int i;
+    (void)arg;
+    Moxie_spy(test_add)();
+    for (i = 0; i < 3; ++i)
+    {
+        TEST_CHECK(test_add(i, 1) == i + 1);
+    }
+    TEST_CHECK(Moxie_threadCallCount(test_add)() == 3);
+    Moxie_reset(test_add)();
+    TEST_CHECK(Moxie_threadCallCount(test_add)() == 0);
+    return NULL;
+}
+
+static void *
+leaver(void *arg)
+{
+    (void)arg;
+    Moxie_spy(test_add)();
+    TEST_CHECK(test_add(1, 1) == 2);
+    return NULL;
+}
+
+int
+main(void)
+{
+    const int *armed = Moxie_findByName("test_add")->armed;
+    int published;
+    pthread_t thread;
+
+    Moxie_spy(test_add)();
+    Moxie_publish(test_add)();
+    TEST_CHECK(test_add(1, 2) == 3);
+    TEST_CHECK(test_add(2, 2) == 4);
+
+    pthread_create(&thread, NULL, &worker, NULL);
+    pthread_join(thread, NULL);
+
+    TEST_CHECK(Moxie_callCount(test_add)() == 5);
+    TEST_CHECK(Moxie_threadCallCount(test_add)() == 2);
+
+    Moxie_resetAll();
+    TEST_CHECK(Moxie_callCount(test_add)() == 0);
+    TEST_CHECK(Moxie_threadCallCount(test_add)() == 0);
+
+    published = *armed;
+    pthread_create(&thread, NULL, &leaver, NULL);
+    pthread_join(thread, NULL);
+    TEST_CHECK(*armed == published);
+    return TEST_RESULT();
+}
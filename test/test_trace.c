@@ -0,0 +1,103 @@
+/*
+ * Moxie_dumpTrace(path):
+ * The traced calls of every thread are dumped as complete events of the Chrome
+ * Trace Event JSON format, of which each thread keeps the latest
+ * MOXIE_TRACE_CAPACITY in its ring buffer, including the calls that reach
+ * CppUMock.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define MOXIE_TRACE_CAPACITY 4
+#define MOXIE_TRACE_SHARDS 2
+
+#include "moxie_test.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+M_DECLARE_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+M_IMPLEMENT_MOCK(
+    M_RETURN_INT(int),
+    test_add,
+    M_PARAM_INT(int,x),
+    M_PARAM_INT(int,y)
+);
+
+static void *
+worker(void *arg)
+{
+    (void)arg;
+    TEST_CHECK(test_add(5, 5) == 10);
+    return NULL;
+}
+
+static unsigned long
+occurrences(const char *text, const char *pattern)
+{
+    unsigned long count = 0;
+    while ((text = strstr(text, pattern)) != NULL)
+    {
+        ++count;
+        ++text;
+    }
+    return count;
+}
+
+int
+main(void)
+{
+    char path[] = "/tmp/moxie_test_trace.XXXXXX";
+    char text[4096];
+    pthread_t thread;
+    size_t length;
+    FILE *file;
+    int fd;
+    int i;
+
+    fd = mkstemp(path);
+    TEST_CHECK(fd >= 0);
+    close(fd);
+
+    /* CppUMock fails upon any call of a trace: */
+    Moxie_trace(test_add)();
+    for (i = 0; i < 6; ++i)
+    {
+        TEST_CHECK(test_add(i, 1) == i + 1);
+    }
+    pthread_create(&thread, NULL, &worker, NULL);
+    pthread_join(thread, NULL);
+
+    Moxie_enable(test_add)();
+    mock_c()->expectOneCall("test_add")->withIntParameters("x", 3)->withIntParameters("y", 4)->andReturnIntValue(0);
+    TEST_CHECK(test_add(3, 4) == 0);
+    TEST_CHECK_EXPECTATIONS();
+
+    Moxie_reset(test_add)();
+    TEST_CHECK(test_add(1, 1) == 2);
+
+    TEST_CHECK(Moxie_dumpTrace(path) == 0);
+    file = fopen(path, "r");
+    TEST_CHECK(file != NULL);
+    length = fread(text, 1, sizeof(text) - 1, file);
+    fclose(file);
+    text[length] = '\0';
+    unlink(path);
+
+    TEST_CHECK(strncmp(text, "{\"traceEvents\":[", 16) == 0);
+    TEST_CHECK(strstr(text, "\"displayTimeUnit\":\"ns\"}") != NULL);
+    TEST_CHECK(occurrences(text, "\"name\":\"test_add\"") == 5);
+    TEST_CHECK(occurrences(text, "\"ph\":\"X\"") == 5);
+    TEST_CHECK(occurrences(text, "\"tid\":1,") == 4);
+    TEST_CHECK(occurrences(text, "\"tid\":2,") == 1);
+
+    TEST_CHECK(Moxie_dumpTrace("/nonexistent/moxie.trace.json") == -1);
+    return TEST_RESULT();
+}